@@ -7,6 +7,8 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <climits>
+#include <cstdint>
 
 namespace ilp
 {    
@@ -205,6 +207,7 @@ namespace ilp
         const std::string& name, 
         const Storage& objective, 
         const std::vector<std::string>& vName, 
+        const std::vector<std::pair<int, int>>& vBounds, 
         const std::vector<std::string>& cName, 
         const std::vector<Constraint<Storage>>& constraints
     )
@@ -306,6 +309,20 @@ namespace ilp
             MPS += MPS_RHS + '\n';
         }
 
+        // Default bounds are [0, +inf[
+        MPS += "BOUNDS\n";
+        for (unsigned int i = 0; i < vName.size(); i++)
+        {
+            const std::string begin = "BND1      " + vName[i] + std::string(10 - vName[i].size(), ' ');
+            if (vBounds[i].first == vBounds[i].second)
+            {
+                MPS += " FX " + begin + std::to_string(vBounds[i].first) + '\n';
+                continue;
+            }
+            if (vBounds[i].first != 0)        MPS += " LO " + begin + std::to_string(vBounds[i].first)  + '\n';
+            if (vBounds[i].second != INT32_MAX) MPS += " UP " + begin + std::to_string(vBounds[i].second) + '\n';
+        }
+
         MPS += "ENDATA";
         return MPS;
     }
@@ -338,6 +355,7 @@ namespace ilp
         const std::string& name, 
         const Storage& objective, 
         const std::vector<std::string>& vName, 
+        const std::vector<std::pair<int, int>>& vBounds, 
         const std::vector<std::string>& cName, 
         const std::vector<Constraint<Storage>>& constraints
     )
@@ -357,6 +375,18 @@ namespace ilp
             }
         }
 
+        // Default bounds are [0, +inf[
+        LP += "Bounds\n";
+        for (unsigned int i = 0; i < vName.size(); i++)
+        {
+            if (vBounds[i].first == vBounds[i].second)
+                LP += " " + vName[i] + " = " + std::to_string(vBounds[i].first) + "\n";
+            else if (vBounds[i].second != INT32_MAX)
+                LP += " " + std::to_string(vBounds[i].first) + " <= " + vName[i] + " <= " + std::to_string(vBounds[i].second) + "\n";
+            else if (vBounds[i].first != 0)
+                LP += " " + vName[i] + " >= " + std::to_string(vBounds[i].first) + "\n";
+        }
+
         LP += "Generals\n ";
         for (unsigned int i = 0; i < vName.size(); i++)
             LP += vName[i] + " ";
@@ -364,10 +394,43 @@ namespace ilp
         return LP;
     }
 
+    // Size of a program, to reserve memory or estimate it before building the program
+    struct ModelSize
+    {
+        uint64_t variables = 0;
+        uint64_t rows = 0;
+        uint64_t nonZeros = 0;
+
+        // Approximate memory used by IntegerLinearProgramBuilder<SparseStorage> (names, map nodes)
+        uint64_t Bytes() const
+        {
+            const uint64_t perVariable = sizeof(std::string) + 8 + sizeof(std::pair<int, int>);
+            const uint64_t perRow      = sizeof(std::string) + 8 + sizeof(Constraint<SparseStorage>);
+            const uint64_t perNonZero  = 48; // std::map node
+            return variables * perVariable + rows * perRow + nonZeros * perNonZero;
+        }
+
+        ModelSize& operator+=(const ModelSize& other)
+        {
+            variables += other.variables;
+            rows      += other.rows;
+            nonZeros  += other.nonZeros;
+            return *this;
+        }
+    };
+
     template<typename Storage = SparseStorage>
     class IntegerLinearProgramBuilder
     {
     public:
+        void Reserve(const ModelSize& size)
+        {
+            variableName.reserve(size.variables);
+            variableBounds.reserve(size.variables);
+            constraintsNames.reserve(size.rows);
+            constraints.reserve(size.rows);
+        }
+
         Variable<Storage> CreateVariable(const std::string& prefix, int low = 0, int high = INT32_MAX)
         {
             auto it = categoryCount.find(prefix);
@@ -417,12 +480,296 @@ namespace ilp
             constraints.push_back(std::move(constraint));
         }
 
+        // Forbids the given assignment: at least one of the variables must differ from its value
+        // Variables at one of their bounds need no auxiliary: the distance is linear.
+        // Otherwise:
+        //      d <= x - v + 2 (h - l) (1 - z)
+        //      d <= v - x + 2 (h - l) z
+        // with z binary, so that d <= |x - v|
+        void AddNoGood(const std::string& prefix, const std::vector<uint32_t>& ids, const std::vector<int>& values)
+        {
+            LinearOperation<Storage> distance;
+            int32_t shift = 0;
+            for (uint32_t i = 0; i < ids.size(); i++)
+            {
+                const Variable<Storage> x{ids[i], 1};
+                const int low  = variableBounds[ids[i]].first;
+                const int high = variableBounds[ids[i]].second;
+
+                     if (values[i] == low)  { distance = distance + x; shift -= low;  }
+                else if (values[i] == high) { distance = distance - x; shift += high; }
+                else
+                {
+                    const int range = 2 * (high - low);
+                    Variable<Storage> d = CreateVariable("d", 0, high - low);
+                    Variable<Storage> z = CreateVariable("z", 0, 1);
+
+                    AddConstraint(prefix, d - (x - values[i]) + range * z <= range);
+                    AddConstraint(prefix, d - (values[i] - x) - range * z <= 0);
+                    distance = distance + d;
+                }
+            }
+            AddConstraint(prefix, distance >= 1 - shift);
+        }
+
+        // Bound propagation: each row restricts the range of its variables given the
+        // bounds of the others, until nothing changes (or after maxPasses passes).
+        // INT32_MAX / INT32_MIN bounds are infinite. Returns false if a row can not be 
+        // satisfied, bounds are then partially tightened (by the rows processed before it,
+        // and possibly by some variables of the failing row).
+        bool TightenBounds(int maxPasses = 8)
+        {
+            const long long INF = INT32_MAX;
+            const long long NINF = INT32_MIN;
+
+            auto floorDiv = [](long long a, long long b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); };
+            auto ceilDiv  = [](long long a, long long b) { return a / b + ((a % b != 0) && ((a < 0) == (b < 0))); };
+
+            bool changed = true;
+            for (int pass = 0; pass < maxPasses && changed; pass++)
+            {
+                changed = false;
+                for (const auto& c : constraints)
+                {
+                    bool hasLow = false, hasHigh = false;
+                    long long rowLow = 0, rowHigh = 0;
+                    switch (c.type)
+                    {
+                    case ComparisonType::EQUAL:         hasLow = hasHigh = true; rowLow = rowHigh = c.rhs; break;
+                    case ComparisonType::GREATER:       hasLow  = true; rowLow  = c.rhs + 1LL; break;
+                    case ComparisonType::GREATER_EQUAL: hasLow  = true; rowLow  = c.rhs; break;
+                    case ComparisonType::LOWER:         hasHigh = true; rowHigh = c.rhs - 1LL; break;
+                    case ComparisonType::LOWER_EQUAL:   hasHigh = true; rowHigh = c.rhs; break;
+                    default: continue;
+                    }
+
+                    // Activity range of the row, infinite terms are counted apart
+                    const auto terms = c.coefs.Get();
+                    std::vector<long long> minTerm(terms.size()), maxTerm(terms.size());
+                    long long minAct = 0, maxAct = 0;
+                    int minInf = 0, maxInf = 0;
+                    for (uint32_t t = 0; t < terms.size(); t++)
+                    {
+                        const long long a  = terms[t].second;
+                        const long long lo = variableBounds[terms[t].first].first;
+                        const long long hi = variableBounds[terms[t].first].second;
+
+                        const bool loInf = (lo <= NINF), hiInf = (hi >= INF);
+                        const bool minInfTerm = (a > 0) ? loInf : hiInf;
+                        const bool maxInfTerm = (a > 0) ? hiInf : loInf;
+                        minTerm[t] = minInfTerm ? NINF : a * ((a > 0) ? lo : hi);
+                        maxTerm[t] = maxInfTerm ? INF  : a * ((a > 0) ? hi : lo);
+
+                        if (minInfTerm) minInf++; else minAct += minTerm[t];
+                        if (maxInfTerm) maxInf++; else maxAct += maxTerm[t];
+                    }
+
+                    if ((hasHigh && minInf == 0 && minAct > rowHigh) || (hasLow && maxInf == 0 && maxAct < rowLow)) 
+                        return false;
+
+                    for (uint32_t t = 0; t < terms.size(); t++)
+                    {
+                        const long long a = terms[t].second;
+                        auto& bounds = variableBounds[terms[t].first];
+                        long long lo = bounds.first, hi = bounds.second;
+
+                        // a x <= rowHigh - (activity of others)
+                        const bool minSelfInf = (minTerm[t] == NINF);
+                        if (hasHigh && (minInf == 0 || (minInf == 1 && minSelfInf)))
+                        {
+                            const long long rest = rowHigh - (minAct - (minSelfInf ? 0 : minTerm[t]));
+                            if (a > 0) hi = std::min(hi, floorDiv(rest, a));
+                            else       lo = std::max(lo, ceilDiv(rest, a));
+                        }
+
+                        // a x >= rowLow - (activity of others)
+                        const bool maxSelfInf = (maxTerm[t] == INF);
+                        if (hasLow && (maxInf == 0 || (maxInf == 1 && maxSelfInf)))
+                        {
+                            const long long rest = rowLow - (maxAct - (maxSelfInf ? 0 : maxTerm[t]));
+                            if (a > 0) lo = std::max(lo, ceilDiv(rest, a));
+                            else       hi = std::min(hi, floorDiv(rest, a));
+                        }
+
+                        if (lo > hi) return false;
+                        if (lo != bounds.first || hi != bounds.second)
+                        {
+                            bounds = std::make_pair(int(lo), int(hi));
+                            changed = true;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Whether values (one per variable) satisfy bounds and rows
+        bool IsFeasible(const std::vector<int>& values) const
+        {
+            for (uint32_t i = 0; i < variableBounds.size(); i++)
+                if (values[i] < variableBounds[i].first || values[i] > variableBounds[i].second) return false;
+
+            for (const auto& c : constraints)
+            {
+                int64_t sum = 0;
+                for (const auto& coeff : c.coefs.Get()) sum += int64_t(coeff.second) * values[coeff.first];
+
+                bool ok = true;
+                switch (c.type)
+                {
+                case ComparisonType::EQUAL:         ok = (sum == c.rhs); break;
+                case ComparisonType::NOT_EQUAL:     ok = (sum != c.rhs); break;
+                case ComparisonType::GREATER:       ok = (sum >  c.rhs); break;
+                case ComparisonType::GREATER_EQUAL: ok = (sum >= c.rhs); break;
+                case ComparisonType::LOWER:         ok = (sum <  c.rhs); break;
+                case ComparisonType::LOWER_EQUAL:   ok = (sum <= c.rhs); break;
+                }
+                if (!ok) return false;
+            }
+            return true;
+        }
+
+        void SetBounds(uint32_t id, int low, int high)
+        {
+            variableBounds[id] = std::make_pair(low, high);
+        }
+
+        // Copy of the program without the variables fixed by their bounds, their value 
+        // is moved to the right hand side. Rows keep their index (some may be left empty).
+        // kept[i] is the id in this program of variable i of the copy.
+        IntegerLinearProgramBuilder WithoutFixed(std::vector<uint32_t>& kept) const
+        {
+            IntegerLinearProgramBuilder rslt;
+            rslt.categoryCount = categoryCount;
+
+            kept.clear();
+            std::vector<int64_t> newId(variableName.size(), -1);
+            for (uint32_t i = 0; i < variableName.size(); i++)
+            {
+                if (variableBounds[i].first == variableBounds[i].second) continue;
+
+                newId[i] = kept.size();
+                kept.push_back(i);
+                rslt.variableName.push_back(variableName[i]);
+                rslt.variableBounds.push_back(variableBounds[i]);
+            }
+
+            for (const auto& coeff : objective.Get())
+                if (newId[coeff.first] >= 0) rslt.objective.add(newId[coeff.first], coeff.second);
+
+            rslt.constraintsNames = constraintsNames;
+            for (const auto& c : constraints)
+            {
+                Storage coefs;
+                int32_t rhs = c.rhs;
+                for (const auto& coeff : c.coefs.Get())
+                {
+                    if (newId[coeff.first] >= 0) coefs.add(newId[coeff.first], coeff.second);
+                    else rhs -= coeff.second * variableBounds[coeff.first].first;
+                }
+                rslt.constraints.push_back(Constraint<Storage>{c.type, coefs, rhs});
+            }
+            return rslt;
+        }
+
+        // Splits the program into independent parts: variables sharing a row are in the same part.
+        // vars[c] and rows[c] are the ids in this program of the variables and rows of part c. 
+        // Rows without variables go to the first part.
+        std::vector<IntegerLinearProgramBuilder> Components(
+            std::vector<std::vector<uint32_t>>& vars, 
+            std::vector<std::vector<uint32_t>>& rows) const
+        {
+            std::vector<uint32_t> parent(variableName.size());
+            for (uint32_t i = 0; i < parent.size(); i++) parent[i] = i;
+
+            auto find = [&](uint32_t i) {
+                while (parent[i] != i) i = parent[i] = parent[parent[i]];
+                return i;
+            };
+
+            for (const auto& c : constraints)
+            {
+                const auto coeffs = c.coefs.Get();
+                for (uint32_t t = 1; t < coeffs.size(); t++)
+                {
+                    const uint32_t a = find(coeffs[0].first), b = find(coeffs[t].first);
+                    if (a != b) parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+
+            // Parts are numbered by their first variable
+            std::vector<int64_t> part(variableName.size(), -1);
+            std::vector<uint32_t> newId(variableName.size());
+            vars.clear();
+            for (uint32_t i = 0; i < variableName.size(); i++)
+            {
+                const uint32_t root = find(i);
+                if (part[root] < 0)
+                {
+                    part[root] = vars.size();
+                    vars.emplace_back();
+                }
+                part[i] = part[root];
+                newId[i] = vars[part[i]].size();
+                vars[part[i]].push_back(i);
+            }
+
+            std::vector<IntegerLinearProgramBuilder> rslt(vars.size());
+            rows.assign(vars.size(), {});
+            for (uint32_t c = 0; c < vars.size(); c++)
+            {
+                rslt[c].categoryCount = categoryCount;
+                for (uint32_t i : vars[c])
+                {
+                    rslt[c].variableName.push_back(variableName[i]);
+                    rslt[c].variableBounds.push_back(variableBounds[i]);
+                }
+            }
+
+            for (const auto& coeff : objective.Get())
+                rslt[part[coeff.first]].objective.add(newId[coeff.first], coeff.second);
+
+            for (uint32_t r = 0; r < constraints.size(); r++)
+            {
+                const auto coeffs = constraints[r].coefs.Get();
+                const uint32_t c = coeffs.empty() ? 0 : part[coeffs[0].first];
+                if (c >= rslt.size()) continue;
+
+                Storage coefs;
+                for (const auto& coeff : coeffs) coefs.add(newId[coeff.first], coeff.second);
+
+                rows[c].push_back(r);
+                rslt[c].constraintsNames.push_back(constraintsNames[r]);
+                rslt[c].constraints.push_back(Constraint<Storage>{constraints[r].type, coefs, constraints[r].rhs});
+            }
+            return rslt;
+        }
+
+        // Copy of the program keeping only the selected rows, without objective
+        IntegerLinearProgramBuilder Restricted(const std::vector<bool>& keep) const
+        {
+            IntegerLinearProgramBuilder rslt;
+            rslt.categoryCount  = categoryCount;
+            rslt.variableName   = variableName;
+            rslt.variableBounds = variableBounds;
+
+            for (uint32_t i = 0; i < constraints.size(); i++)
+            {
+                if (!keep[i]) continue;
+
+                rslt.constraintsNames.push_back(constraintsNames[i]);
+                rslt.constraints.push_back(constraints[i]);
+            }
+            return rslt;
+        }
+
         std::string ToMPS(const std::string& name) const 
         {
             return MPS(
                 name, 
                 objective, 
                 variableName, 
+                variableBounds, 
                 constraintsNames, 
                 constraints
             );
@@ -434,6 +781,7 @@ namespace ilp
                 name, 
                 objective, 
                 variableName, 
+                variableBounds, 
                 constraintsNames, 
                 constraints
             );
@@ -1,6 +1,14 @@
 #pragma once
 
 #include <ILP/ILP_def.hpp>
+#include <memory>
+
+// How the seed objective (sum of |x - c|) is written in the program
+enum class ObjectiveEncoding
+{
+    Auxiliary, // One variable and two rows for each x
+    Compact    // Linear in x when c is a bound of x, one variable and one row otherwise
+};
 
 class Backend
 {
@@ -12,6 +20,10 @@ public:
 
         uint32_t to = (1 << 31); // Timeout in seconds
         int32_t threads = 0;
+
+        int32_t conflictSolves = 200; // Maximum number of solves to find a conflict
+
+        ObjectiveEncoding objective = ObjectiveEncoding::Compact;
     private:
     };
 
@@ -19,7 +31,87 @@ public:
 
     virtual std::vector<int> SolveILP(const ILP& ilp) const = 0;
 
+    // Whether several programs can be solved at the same time
+    virtual bool IsThreadSafe() const { return false; }
+
+    // Threads of each solve, 0 for all available
+    int32_t GetThreads() const { return params.threads; }
+
+    // Copy of a thread safe backend with its own number of threads, null otherwise
+    virtual std::unique_ptr<Backend> WithThreads(int32_t /*threads*/) const { return nullptr; }
+
+    // Encoding of the seed objective best suited to this backend
+    virtual ObjectiveEncoding GetObjectiveEncoding() const { return params.objective; }
+
+    // Returns up to poolSize solutions, pairwise distinct on the first keyCount variables.
+    // The first one is the solution SolveILP would return. By default, the program 
+    // is solved again with a no-good cut for each solution found.
+    virtual std::vector<std::vector<int>> SolveILPPool(const ILP& ilp, uint32_t keyCount, uint32_t poolSize) const
+    {
+        std::vector<std::vector<int>> pool;
+        
+        std::vector<int> values = SolveILP(ilp);
+        if (values.empty()) return pool;
+        pool.push_back(values);
+
+        if (poolSize <= 1) return pool;
+
+        std::vector<uint32_t> keys(keyCount);
+        for (uint32_t i = 0; i < keyCount; i++) keys[i] = i;
+
+        ILP current = ilp;
+        while (pool.size() < poolSize)
+        {
+            current.AddNoGood("NG", keys, std::vector<int>(values.begin(), values.begin() + keyCount));
+            
+            values = SolveILP(current);
+            if (values.empty()) break;
+
+            values.resize(ilp.GetVariableNames().size());
+            pool.push_back(values);
+        }
+        return pool;
+    }
+
+    // Returns the rows of an irreducible infeasible subset of an infeasible program, 
+    // empty if none could be found. By default, a deletion filter: blocks of rows are 
+    // removed as long as the program stays infeasible, and split when it does not.
+    virtual std::vector<uint32_t> FindConflict(const ILP& ilp) const
+    {
+        const uint32_t rows = ilp.GetConstraints().size();
+        std::vector<bool> keep(rows, true);
+
+        int32_t solves = 0;
+        std::vector<std::pair<uint32_t, uint32_t>> blocks = { {0, rows} };
+        while (!blocks.empty())
+        {
+            if (solves++ >= params.conflictSolves) return {};
+
+            const auto block = blocks.back();
+            blocks.pop_back();
+
+            for (uint32_t i = block.first; i < block.second; i++) keep[i] = false;
+            if (!SolveILP(ilp.Restricted(keep)).empty())
+            {
+                for (uint32_t i = block.first; i < block.second; i++) keep[i] = true;
+                
+                // Block contains part of the conflict
+                if (block.second - block.first > 1)
+                {
+                    const uint32_t middle = (block.first + block.second) / 2;
+                    blocks.push_back({middle, block.second});
+                    blocks.push_back({block.first, middle});
+                }
+            }
+        }
+
+        std::vector<uint32_t> conflict;
+        for (uint32_t i = 0; i < rows; i++)
+            if (keep[i]) conflict.push_back(i);
+        return conflict;
+    }
+
     virtual ~Backend() {}
 protected:
     BackendParams params;
-};
\ No newline at end of file
+};
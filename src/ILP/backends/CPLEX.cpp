@@ -2,7 +2,10 @@
 
 #include <ilcplex/ilocplex.h>
 
-std::vector<int> CPLEXBackend::SolveILP(const ILP& ilp) const
+// c[i] is the constraint built from row rows[i] of the program
+static void BuildModel(
+    const ILP& ilp, IloEnv& env, IloModel& model, IloNumVarArray& vars, 
+    IloConstraintArray& c, std::vector<uint32_t>& rows)
 {
     const auto& constraints = ilp.GetConstraints();
     
@@ -10,11 +13,7 @@ std::vector<int> CPLEXBackend::SolveILP(const ILP& ilp) const
     const auto& vNames  = ilp.GetVariableNames();
     const auto& vBounds = ilp.GetVariablesBounds();
 
-    IloEnv env;
-    IloModel model(env);
-    IloNumVarArray vars(env);
     IloNumVarArray ks(env);
-    IloConstraintArray c(env);
     IloNumExpr weakObj(env);
     IloNumVarArray weakVars(env);
 
@@ -53,8 +52,9 @@ std::vector<int> CPLEXBackend::SolveILP(const ILP& ilp) const
 
         case ilp::ComparisonType::NOT_EQUAL: 
         default:
-            break;
+            continue;
         }
+        rows.push_back(i);
     }   
 
     IloNumExpr obj(env);
@@ -63,26 +63,127 @@ std::vector<int> CPLEXBackend::SolveILP(const ILP& ilp) const
     
     model.add(IloMinimize(env, obj));
     model.add(c);
+}
 
-    IloCplex cplex(model);
+static void SetParams(IloCplex& cplex, const Backend::BackendParams& params)
+{
     cplex.setParam(IloCplex::Param::ParamDisplay, 0);
     cplex.setParam(IloCplex::Param::MIP::Display, 0);
     cplex.setParam(IloCplex::Param::MIP::Interval, 1000000);
     cplex.setParam(IloCplex::Param::Threads, params.threads);
     cplex.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, params.tol);
     cplex.setParam(IloCplex::Param::TimeLimit , params.to);
+}
 
-    bool success = cplex.solve();
-
-    if (!success) return {};
-
+static std::vector<int> GetValues(IloCplex& cplex, IloEnv& env, IloNumVarArray& vars, int soln = -1)
+{
     IloNumArray vals(env);
-    cplex.getValues(vals, vars);
+    if (soln < 0) cplex.getValues(vals, vars);
+    else          cplex.getValues(vals, vars, soln);
 
-    std::vector<int> values(vNames.size());
-    for (unsigned int i = 0; i < vNames.size(); i++)
+    std::vector<int> values(vars.getSize());
+    for (unsigned int i = 0; i < values.size(); i++)
     {
         values[i] = IloRound(vals[i]);
     }
+    return values;
+}
+
+std::vector<int> CPLEXBackend::SolveILP(const ILP& ilp) const
+{
+    IloEnv env;
+    IloModel model(env);
+    IloNumVarArray vars(env);
+    IloConstraintArray c(env);
+    std::vector<uint32_t> rows;
+    BuildModel(ilp, env, model, vars, c, rows);
+
+    IloCplex cplex(model);
+    SetParams(cplex, params);
+
+    bool success = cplex.solve();
+
+    std::vector<int> values;
+    if (success) values = GetValues(cplex, env, vars);
+    
+    env.end();
     return values;  
+}
+
+std::vector<std::vector<int>> CPLEXBackend::SolveILPPool(const ILP& ilp, uint32_t keyCount, uint32_t poolSize) const
+{
+    if (poolSize <= 1) 
+    {
+        std::vector<int> values = SolveILP(ilp);
+        if (values.empty()) return {};
+        return { values };
+    }
+
+    IloEnv env;
+    IloModel model(env);
+    IloNumVarArray vars(env);
+    IloConstraintArray c(env);
+    std::vector<uint32_t> rows;
+    BuildModel(ilp, env, model, vars, c, rows);
+
+    IloCplex cplex(model);
+    SetParams(cplex, params);
+    cplex.setParam(IloCplex::Param::MIP::Pool::Capacity, poolSize);
+    cplex.setParam(IloCplex::Param::MIP::Pool::Replace, 2);  // Keep diverse solutions
+    cplex.setParam(IloCplex::Param::MIP::Limits::Populate, poolSize);
+
+    std::vector<std::vector<int>> pool;
+    if (cplex.populate() && cplex.getSolnPoolNsolns() > 0)
+    {
+        // Incumbent first, then by objective
+        std::vector<std::pair<double, int>> order;
+        for (int i = 0; i < cplex.getSolnPoolNsolns(); i++)
+            order.push_back(std::make_pair(cplex.getObjValue(i), i));
+        std::sort(order.begin(), order.end());
+        
+        pool.push_back(GetValues(cplex, env, vars));
+        for (const auto& it : order)
+        {
+            std::vector<int> values = GetValues(cplex, env, vars, it.second);
+
+            bool duplicate = false;
+            for (const auto& other : pool)
+                duplicate = duplicate || std::equal(values.begin(), values.begin() + keyCount, other.begin());
+
+            if (!duplicate && pool.size() < poolSize) pool.push_back(values);
+        }
+    }
+
+    env.end();
+    return pool;
+}
+
+std::vector<uint32_t> CPLEXBackend::FindConflict(const ILP& ilp) const
+{
+    IloEnv env;
+    IloModel model(env);
+    IloNumVarArray vars(env);
+    IloConstraintArray c(env);
+    std::vector<uint32_t> rows;
+    BuildModel(ilp, env, model, vars, c, rows);
+
+    IloCplex cplex(model);
+    SetParams(cplex, params);
+
+    std::vector<uint32_t> conflict;
+    IloNumArray prefs(env, c.getSize());
+    for (IloInt i = 0; i < c.getSize(); i++) prefs[i] = 1.0;
+
+    if (cplex.refineConflict(c, prefs))
+    {
+        IloCplex::ConflictStatusArray status = cplex.getConflict(c);
+        for (IloInt i = 0; i < c.getSize(); i++)
+        {
+            if (status[i] == IloCplex::ConflictMember || status[i] == IloCplex::ConflictPossibleMember)
+                conflict.push_back(rows[i]);
+        }
+    }
+
+    env.end();
+    return conflict;
 }
\ No newline at end of file
@@ -8,4 +8,20 @@ public:
     CPLEXBackend(Backend::BackendParams& params): Backend(params) {}   
 
     std::vector<int> SolveILP(const ILP& ilp) const;
-};
\ No newline at end of file
+
+    // Each solve has its own environment
+    bool IsThreadSafe() const { return true; }
+
+    std::unique_ptr<Backend> WithThreads(int32_t threads) const
+    {
+        BackendParams copy = params;
+        copy.threads = threads;
+        return std::make_unique<CPLEXBackend>(copy);
+    }
+
+    // Uses CPLEX solution pool (populate) instead of no-good cuts
+    std::vector<std::vector<int>> SolveILPPool(const ILP& ilp, uint32_t keyCount, uint32_t poolSize) const;
+
+    // Uses CPLEX conflict refiner
+    std::vector<uint32_t> FindConflict(const ILP& ilp) const;
+};
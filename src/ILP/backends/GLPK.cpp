@@ -16,11 +16,17 @@ std::vector<int> GLPKBackend::SolveILP(const ILP& ilp) const
     glp_set_obj_dir(lp, GLP_MIN);
 
     // Declare variables
-    glp_add_cols(lp, vNames.size());
+    // GLPK refuses to add zero rows or columns
+    if (vNames.size() > 0) glp_add_cols(lp, vNames.size());
     for (unsigned int i = 0; i < vNames.size(); i++)
     {
         glp_set_col_name(lp, i + 1, vNames[i].c_str());
-        glp_set_col_bnds(lp, i + 1, GLP_DB, vBounds[i].first, vBounds[i].second);
+        if (vBounds[i].first == vBounds[i].second)
+            glp_set_col_bnds(lp, i + 1, GLP_FX, vBounds[i].first, vBounds[i].second);
+        else if (vBounds[i].second == INT32_MAX)
+            glp_set_col_bnds(lp, i + 1, GLP_LO, vBounds[i].first, vBounds[i].second);
+        else
+            glp_set_col_bnds(lp, i + 1, GLP_DB, vBounds[i].first, vBounds[i].second);
         glp_set_col_kind(lp, i + 1, GLP_IV);
     }
 
@@ -36,7 +42,7 @@ std::vector<int> GLPKBackend::SolveILP(const ILP& ilp) const
     std::vector<double> ra(1 + sum, 0);
     
     unsigned int valueCount = 1;
-    glp_add_rows(lp, constraints.size());
+    if (constraints.size() > 0) glp_add_rows(lp, constraints.size());
     for (unsigned int i = 0; i < constraints.size(); i++)
     {
         glp_set_row_name(lp, i + 1, cNames[i].c_str());
@@ -81,7 +87,13 @@ std::vector<int> GLPKBackend::SolveILP(const ILP& ilp) const
 
     int err = glp_intopt(lp, &parm);
     
-    if (err != 0) return {};
+    // An infeasible program is not an error for glp_intopt
+    const int status = glp_mip_status(lp);
+    if (err != 0 || (status != GLP_OPT && status != GLP_FEAS)) 
+    {
+        glp_delete_prob(lp);
+        return {};
+    }
     
     std::vector<int> values(vNames.size());
 
@@ -0,0 +1,141 @@
+#include "Checkpoint.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+static const std::string CHECKPOINT_MAGIC = "matbuilder-checkpoint";
+static const int CHECKPOINT_VERSION = 1;
+
+template<typename T>
+void WriteVector(std::ostream& out, const std::vector<T>& values)
+{
+    out << values.size();
+    for (const auto& v : values) out << ' ' << v;
+    out << '\n';
+}
+
+template<typename T>
+bool ReadVector(std::istream& in, std::vector<T>& values)
+{
+    size_t size = 0;
+    if (!(in >> size)) return false;
+
+    values.resize(size);
+    for (auto& v : values) 
+        if (!(in >> v)) return false;
+    return true;
+}
+
+bool Checkpoint::Save(const std::string& filename) const
+{
+    const std::string tmp = filename + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out.is_open()) return false;
+
+        out << CHECKPOINT_MAGIC << ' ' << CHECKPOINT_VERSION << '\n';
+        out << "hash " << hash << '\n';
+        out << "seed " << seed << '\n';
+        out << "step " << state.m << ' ' << state.greedyFails << ' ' << state.backtrackCounts << ' ' << state.prefix << '\n';
+        out << "rng " << rng << '\n';
+        
+        out << "matrices " << state.result.size() << '\n';
+        for (const auto& mat : state.result)
+            mat.To(out);
+
+        out << "candidates " << state.candidates.size() << '\n';
+        for (const auto& level : state.candidates)
+        {
+            out << level.size() << '\n';
+            for (const auto& values : level) WriteVector(out, values);
+        }
+
+        out << "nogoods " << state.nogoods.size() << '\n';
+        for (const auto& level : state.nogoods)
+        {
+            out << level.size() << '\n';
+            for (const auto& nogood : level)
+            {
+                WriteVector(out, nogood.first);
+                WriteVector(out, nogood.second);
+            }
+        }
+
+        out.flush();
+        if (!out.good()) return false;
+    }
+    return std::rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+bool Checkpoint::Load(const std::string& filename, Checkpoint& checkpoint)
+{
+    std::ifstream in(filename);
+    if (!in.is_open()) return false;
+
+    std::string token;
+    int version = 0;
+    if (!(in >> token >> version) || token != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION) 
+        return false;
+
+    Solver::State& state = checkpoint.state;
+    
+    if (!(in >> token >> checkpoint.hash) || token != "hash") return false;
+    if (!(in >> token >> checkpoint.seed) || token != "seed") return false;
+    if (!(in >> token >> state.m >> state.greedyFails >> state.backtrackCounts >> state.prefix) || token != "step") return false;
+    if (!(in >> token >> checkpoint.rng) || token != "rng") return false;
+
+    size_t count = 0;
+    if (!(in >> token >> count) || token != "matrices") return false;
+    std::getline(in, token);
+
+    state.result.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        state.result.push_back(GFMatrix::From(in));
+        if (state.result.back().size() == 0) return false;
+    }
+
+    if (!(in >> token >> count) || token != "candidates") return false;
+    state.candidates.assign(count, {});
+    for (auto& level : state.candidates)
+    {
+        if (!(in >> count)) return false;
+        level.resize(count);
+        for (auto& values : level)
+            if (!ReadVector(in, values)) return false;
+    }
+
+    if (!(in >> token >> count) || token != "nogoods") return false;
+    state.nogoods.assign(count, {});
+    for (auto& level : state.nogoods)
+    {
+        if (!(in >> count)) return false;
+        level.resize(count);
+        for (auto& nogood : level)
+            if (!ReadVector(in, nogood.first) || !ReadVector(in, nogood.second)) return false;
+    }
+
+    return true;
+}
+
+uint64_t ProgramHash(const std::string& filename, const MatbuilderProgram& program)
+{
+    // FNV-1a, stable between runs and platforms
+    uint64_t hash = 14695981039346656037ull;
+    auto combine = [&hash](const std::string& str) {
+        for (unsigned char c : str)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+
+    combine(content.str());
+    combine(std::to_string(program.m) + " " + std::to_string(program.s) + " " + std::to_string(program.p));
+    return hash;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <random>
+
+#include "Solver.hpp"
+
+// Saved state of a Solver::solve run
+struct Checkpoint
+{
+    uint64_t hash = 0;
+    int seed = 0;
+    std::mt19937 rng;
+    Solver::State state;
+
+    // Writes to a temporary file first, then renames it, so that 
+    // an interrupted save never replaces a valid checkpoint
+    bool Save(const std::string& filename) const;
+
+    static bool Load(const std::string& filename, Checkpoint& checkpoint);
+};
+
+// Identifies a profile: its content and overriden sizes
+uint64_t ProgramHash(const std::string& filename, const MatbuilderProgram& program);
@@ -1,10 +1,14 @@
 #include "Constraints.hpp"
 
+#include <set>
+#include <algorithm>
+
+template<class Field>
 std::vector<int> constraintMkSubdets(
     int currentM, 
-    const std::vector<GFMatrix>& matrices, 
+    const std::vector<GFMatrixView>& matrices, 
     const std::vector<int>& k, 
-    const Galois::Field& gf)
+    const Field& gf)
 {
     const int m = currentM;
 
@@ -38,7 +42,7 @@ std::vector<int> constraintMkSubdets(
     prevlines = 0;
     for (int row = 0; row < m; row++)
     {
-        int idet = factor * matrix.determinant(gf, currentM);
+        int idet = factor * matrix.Determinant(gf, currentM);
         subdets[row] = idet;
         factor *= -1;
 
@@ -64,6 +68,148 @@ std::vector<int> constraintMkSubdets(
     return subdets;
 }
 
+// Cofactors of the last column for every split of two matrices at once, up to a non zero
+// factor per split: result[a] is for a rows of the first matrix and currentM - a of the
+// second, as constraintMkSubdets. Left null vectors are not changed by column operations:
+// the first matrix is put in column echelon form, so that the known columns free of its
+// first a rows are a suffix, and the rows of the second matrix (columns reversed) are
+// reduced by leading position, so that every split reads its null vector. O(m^3) in all.
+template<class Field>
+std::vector<std::vector<int>> constraintMkSplitCofactors(
+    int currentM, 
+    const GFMatrixView& first, 
+    const GFMatrixView& second, 
+    const Field& gf)
+{
+    const int m = currentM;
+    const int n = m - 1;
+
+    GFMatrix a(n), b(n);
+    for (int row = 0; row < n; row++)
+    {
+        for (int col = 0; col < n; col++)
+        {
+            a[row][col] = first[row][col];
+            b[row][col] = second[row][col];
+        }
+    }
+
+    // Column echelon form of a, same column operations on b. order has the pivot columns,
+    // in the order of their rows, then the others. rank[i] is the rank of the first i rows.
+    std::vector<int> order, pivotRows, dependentRows, rank(m, 0);
+    std::vector<bool> used(n, false);
+    for (int row = 0; row < n; row++)
+    {
+        rank[row] = order.size();
+
+        int pivot = 0;
+        while (pivot < n && (used[pivot] || a[row][pivot] == 0)) pivot++;
+        if (pivot == n)
+        {
+            dependentRows.push_back(row);
+            continue;
+        }
+
+        used[pivot] = true;
+        order.push_back(pivot);
+        pivotRows.push_back(row);
+
+        const int inv = gf.inv[a[row][pivot]];
+        for (int col = 0; col < n; col++)
+        {
+            if (used[col] || a[row][col] == 0) continue;
+
+            const int factor = gf.neg[gf.times(a[row][col], inv)];
+            for (int r = row; r < n; r++) a[r][col] = gf.plus(a[r][col], gf.times(factor, a[r][pivot]));
+            for (int r = 0;   r < n; r++) b[r][col] = gf.plus(b[r][col], gf.times(factor, b[r][pivot]));
+        }
+    }
+    rank[n] = order.size();
+    for (int col = 0; col < n; col++)
+        if (!used[col]) order.push_back(col);
+
+    // Rows of b over the reversed order, reduced by leading position. reduced[i] is
+    // transform[i] (combination of the rows up to i, 1 on row i) times these rows.
+    std::vector<std::vector<int>> reduced(n, std::vector<int>(n)), transform(n, std::vector<int>(n, 0));
+    std::vector<int> lead(n), byLead(n, -1);
+    for (int row = 0; row < n; row++)
+    {
+        std::vector<int>& vec = reduced[row];
+        std::vector<int>& t = transform[row];
+        for (int col = 0; col < n; col++) vec[col] = b[row][order[n - 1 - col]];
+        t[row] = 1;
+
+        int p = 0;
+        while (p < n && vec[p] == 0) p++;
+        while (p < n && byLead[p] >= 0)
+        {
+            const int other = byLead[p];
+            const int factor = gf.neg[gf.times(vec[p], gf.inv[reduced[other][p]])];
+            for (int col = p; col < n; col++) vec[col] = gf.plus(vec[col], gf.times(factor, reduced[other][col]));
+            for (int i = 0; i <= other; i++) t[i] = gf.plus(t[i], gf.times(factor, transform[other][i]));
+
+            while (p < n && vec[p] == 0) p++;
+        }
+
+        lead[row] = p;
+        if (p < n) byLead[p] = row;
+    }
+
+    // Rows of b among the first count whose leading position is at least from
+    auto countLeads = [&](int count, int from, int* last) {
+        int found = 0;
+        for (int i = 0; i < count; i++)
+            if (lead[i] >= from) { found++; *last = i; }
+        return found;
+    };
+
+    std::vector<std::vector<int>> cofactors(m + 1, std::vector<int>(m, 0));
+    int last = 0;
+
+    // Single matrix: its row m - 1 is left out of the known columns, as constraintMkSubdets
+    cofactors[m][m - 1] = (rank[n] == n) ? 1 : 0;
+    cofactors[0][m - 1] = (countLeads(n, n, &last) == 0) ? 1 : 0;
+
+    for (int rowsA = 1; rowsA < m; rowsA++)
+    {
+        const int rowsB = m - rowsA;
+        const int dependent = rowsA - rank[rowsA];
+        std::vector<int>& cof = cofactors[rowsA];
+
+        // The free columns of a are the last n - rank[rowsA] of order: in the reduced rows,
+        // the first rowsB - 1 + dependent columns. The split has rank m - 1 if either the
+        // rows of a are independent and the rows of b have a single dependency on these
+        // columns, or a has one dependent row and b none.
+        if (dependent == 0)
+        {
+            if (countLeads(rowsB, rowsB - 1, &last) != 1) continue;
+            for (int i = 0; i <= last; i++) cof[rowsA + i] = transform[last][i];
+        }
+        else if (dependent == 1)
+        {
+            if (countLeads(rowsB, rowsB, &last) != 0) continue;
+            cof[dependentRows[0]] = 1;
+        }
+        else continue;
+
+        // Pivot columns of a: pivot rows are solved from the last, each pivot column being
+        // zero on the rows before its own
+        for (int j = rank[rowsA] - 1; j >= 0; j--)
+        {
+            const int col = order[j];
+            int sum = 0;
+            for (int i = 0; i < rowsB; i++)
+                if (cof[rowsA + i] != 0) sum = gf.plus(sum, gf.times(cof[rowsA + i], b[i][col]));
+            for (int i = pivotRows[j] + 1; i < rowsA; i++)
+                if (cof[i] != 0) sum = gf.plus(sum, gf.times(cof[i], a[i][col]));
+
+            cof[pivotRows[j]] = gf.neg[gf.times(sum, gf.inv[a[pivotRows[j]][col]])];
+        }
+    }
+
+    return cofactors;
+}
+
 void positions2k(const std::vector<int>& positions, std::vector<int>& k, int& unblance, int max)
 {
     if (positions.empty())
@@ -118,23 +264,24 @@ bool advancePositions(std::vector<int>& positions, int max)
     return true;
 }
 
-void constraintMk(
+// Linear form of the determinant for composition k, from the cofactors dets of its last column,
+// as (variable, coefficient) sorted by variable.
+// A non-zero form stays non-zero when scaled: the first coefficient is made 1.
+template<class Field>
+Constraint::GFRow constraintMkRow(
     int currentM, 
-    const Galois::Field& gf, 
-    const std::vector<GFMatrix>& mats, 
-    const Constraint::Modifier& modifier,
+    const Field& gf, 
+    const std::vector<int>& dets, 
 
     const std::vector<int>& k,
     const std::vector<int>& dims, 
     
-    ILP& ilp, const Var* variables, Exp& obj)
+    const Var* variables)
 {
-    Exp det = ilp.CreateOperation();
-
-    const std::vector<int> dets = constraintMkSubdets(currentM, mats, k, gf);
     int indMat = 0; 
     int prevlines = 0;
 
+    Constraint::GFRow row;
     for (int j = 0; j < currentM; j++)
     {
         while (j - prevlines >= k[indMat])
@@ -143,8 +290,41 @@ void constraintMk(
             indMat++;
         }
 
-        det = det + dets[j] * variables[j - prevlines + dims[indMat] * currentM];
+        if (dets[j] != 0)
+            row.push_back({variables[j - prevlines + dims[indMat] * currentM].id, dets[j]});
     }
+    std::sort(row.begin(), row.end());
+
+    if (!row.empty())
+    {
+        const int factor = gf.inv[row[0].second];
+        for (auto& coeff : row) coeff.second = gf.times(coeff.second, factor);
+    }
+    return row;
+}
+
+template<class Field>
+void constraintMk(
+    int currentM, 
+    const Field& gf, 
+    const std::vector<int>& dets, 
+    const Constraint::Modifier& modifier,
+
+    const std::vector<int>& k,
+    const std::vector<int>& dims, 
+    
+    ILP& ilp, const Var* variables, Exp& obj, 
+    std::set<Constraint::GFRow>& emitted, std::vector<Constraint::GFRow>* forms)
+{
+    const auto row = constraintMkRow(currentM, gf, dets, k, dims, variables);
+
+    // Weak rows each count in the objective, hard ones are only needed once
+    if (!modifier.weak && !emitted.insert(row).second) return;
+    if (forms) forms->push_back(row);
+
+    Exp det = ilp.CreateOperation();
+    for (const auto& coeff : row)
+        det = det + coeff.second * Var{coeff.first, 1};
 
     Var ks = ilp.CreateVariable("k");
     det = det - ks * gf.q;
@@ -179,29 +359,185 @@ void constraintMk(
     }
 }
 
-void ZeroNetConstraint::Apply(
+// Rows of the composition k, with only the first cols columns filled
+GFMatrix constraintMkRows(
+    int currentM, 
+    const std::vector<GFMatrixView>& matrices, 
+    const std::vector<int>& k, 
+    int cols)
+{
+    const int m = currentM;
+    GFMatrix stacked(m);
+
+    int indMat = 0;
+    int prevlines = 0;
+    for (int row = 0; row < m; row++)
+    {
+        while (row - prevlines >= k[indMat])
+        {
+            prevlines += k[indMat];
+            indMat++;
+        }
+
+        for (int col = 0; col < cols; col++)
+            stacked[row][col] = matrices[indMat][row - prevlines][col];
+    }
+    return stacked;
+}
+
+template<class Field>
+int constraintMkDependentPrefix(
+    int currentM, 
+    const std::vector<GFMatrixView>& matrices, 
+    const std::vector<int>& k, 
+    const Field& gf)
+{
+    const int m = currentM;
+
+    // Only the m - 1 known columns are used
+    const GFMatrix stacked = constraintMkRows(currentM, matrices, k, m - 1);
+
+    // Columns are reduced one after the other against the previous ones, 
+    // the first one that vanishes gives the dependent prefix.
+    std::vector<std::vector<int>> basis;
+    std::vector<int> pivots;
+    for (int col = 0; col < m - 1; col++)
+    {
+        std::vector<int> vec(m);
+        for (int row = 0; row < m; row++) vec[row] = stacked[row][col];
+
+        for (unsigned int b = 0; b < basis.size(); b++)
+        {
+            if (vec[pivots[b]] == 0) continue;
+            
+            const int factor = gf.neg[gf.times(vec[pivots[b]], gf.inv[basis[b][pivots[b]]])];
+            for (int row = 0; row < m; row++)
+                vec[row] = gf.plus(vec[row], gf.times(factor, basis[b][row]));
+        }
+
+        int pivot = 0;
+        while (pivot < m && vec[pivot] == 0) pivot++;
+
+        if (pivot == m) return col + 1;
+
+        basis.push_back(vec);
+        pivots.push_back(pivot);
+    }
+    return 0;
+}
+
+std::vector<GFMatrixView> Constraint::SelectMatrices(const std::vector<GFMatrix>& matrices) const
+{
+    std::vector<GFMatrixView> mat;
+    for (unsigned int i = 0; i < dims.size(); i++)
+        mat.push_back(matrices[dims[i]]);
+    return mat;
+}
+
+void Constraint::Apply(
         const std::vector<GFMatrix>& matrices, 
         const Galois::Field& gf, 
         unsigned int currentM, 
 
-        ILP& ilp, const Var* variables, Exp& obj
+        ILP& ilp, const Var* variables, Exp& obj, 
+        std::vector<GFRow>* forms
+) const
+{
+    if (!IsActive(currentM)) return;
+
+    const std::vector<GFMatrixView> mats = SelectMatrices(matrices);
+
+    const auto skip = skipped.find(currentM);
+
+    std::set<GFRow> emitted;
+    GF::WithField(gf, [&](const auto& field) {
+        // Two matrices share one elimination for all their splits. Rows are normalized, so
+        // cofactors up to a factor are enough; for prime powers the general path is kept,
+        // its signs being those of integers.
+        std::vector<std::vector<int>> splits;
+        if (dims.size() == 2 && currentM >= 2 && GF::IsPrime(gf.q))
+            splits = constraintMkSplitCofactors(currentM, mats[0], mats[1], field);
+
+        ForEachComposition(currentM, [&](const std::vector<int>& k) {
+            if (skip != skipped.end() && skip->second.count(k)) return;
+
+            const std::vector<int> dets = splits.empty() ? constraintMkSubdets(currentM, mats, k, field) : splits[k[0]];
+            constraintMk(currentM, field, dets, modifier, k, dims, ilp, variables, obj, emitted, forms);
+        });
+    });
+}
+
+void Constraint::EstimateSize(unsigned int currentM, int q, ilp::ModelSize& size) const
+{
+    if (!IsActive(currentM)) return;
+
+    uint64_t count = 0;
+    ForEachComposition(currentM, [&](const std::vector<int>&) { count++; });
+    count -= SkippedCount(currentM);
+
+    // Same rows as constraintMk: each determinant row has up to currentM x and its k
+    if (modifier.weak)
+    {
+        size.variables += 2 * count;
+        size.rows      += 2 * count;
+        size.nonZeros  += (2 * (currentM + 1) + 1) * count;
+    }
+    else
+    {
+        const uint64_t rows = (q == 2) ? 1 : 2;
+        size.variables += count;
+        size.rows      += rows * count;
+        size.nonZeros  += rows * (currentM + 1) * count;
+    }
+}
+
+int Constraint::DependentPrefix(
+        const std::vector<GFMatrix>& matrices, 
+        const Galois::Field& gf, 
+        unsigned int currentM
 ) const
 {
-    if (currentM < modifier.minM || currentM > modifier.maxM) return;
+    if (!IsActive(currentM)) return 0;
+
+    const std::vector<GFMatrixView> mats = SelectMatrices(matrices);
+
+    int prefix = 0;
+    GF::WithField(gf, [&](const auto& field) {
+        ForEachComposition(currentM, [&](const std::vector<int>& k) {
+            const int cols = constraintMkDependentPrefix(currentM, mats, k, field);
+            if (cols > 0 && (prefix == 0 || cols < prefix)) prefix = cols;
+        });
+    });
+    return prefix;
+}
 
+bool Constraint::Check(
+        const std::vector<GFMatrix>& matrices, 
+        const Galois::Field& gf, 
+        unsigned int currentM
+) const
+{
+    if (!IsActive(currentM)) return true;
+
+    const std::vector<GFMatrixView> mats = SelectMatrices(matrices);
+
+    bool valid = true;
+    GF::WithField(gf, [&](const auto& field) {
+        ForEachComposition(currentM, [&](const std::vector<int>& k) {
+            if (valid) valid = (constraintMkRows(currentM, mats, k, currentM).Determinant(field) != 0);
+        });
+    });
+    return valid;
+}
+
+void ZeroNetConstraint::ForEachComposition(unsigned int currentM, const CompositionCallback& f) const
+{
     int s = dims.size();
     std::vector<int> k(s);
     std::vector<int> positions(s - 1);
 
     for (int i = 0; i < s - 1; i++) positions[i] = i;
 
-    const std::vector<GFMatrix> mats = [&](){
-        std::vector<GFMatrix> mat;
-        for (unsigned int i = 0; i < dims.size(); i++)
-            mat.push_back(matrices[dims[i]]);
-        return mat;
-    }();
-
     do
     {
         int unblance = 0;
@@ -209,29 +545,14 @@ void ZeroNetConstraint::Apply(
 
         if (unblance <= max_unblance)
         {
-            constraintMk(currentM, gf, mats, modifier, k, dims, ilp, variables, obj);
+            f(k);
         }
 
     } while(advancePositions(positions, currentM + s - 2));
 }
 
-void StratifiedConstraint::Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-) const
+void StratifiedConstraint::ForEachComposition(unsigned int currentM, const CompositionCallback& f) const
 {
-    if (currentM < modifier.minM || currentM > modifier.maxM) return;
-
-    const std::vector<GFMatrix> mats = [&](){
-        std::vector<GFMatrix> mat;
-        for (unsigned int i = 0; i < dims.size(); i++)
-            mat.push_back(matrices[dims[i]]);
-        return mat;
-    }();
-
     std::vector<int> positions(currentM % dims.size(), 0);
     for (int i = 0; i < positions.size(); i++)
         positions[i] = i;
@@ -243,7 +564,7 @@ void StratifiedConstraint::Apply(
         for (int i = 0; i < positions.size(); i++)
             k[positions[i]] += 1;
 
-        constraintMk(currentM, gf, mats, modifier, k, dims, ilp, variables, obj);
+        f(k);
 
         for (int i = 0; i < positions.size(); i++)
             k[positions[i]] -= 1;
@@ -251,27 +572,14 @@ void StratifiedConstraint::Apply(
     } while(advancePositions(positions, dims.size() - 1));
 }
 
-void PropAConstraint::Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-) const
+void PropAConstraint::ForEachComposition(unsigned int currentM, const CompositionCallback& f) const
 {
     if (currentM == dims.size()) 
-        StratifiedConstraint::Apply(matrices, gf, currentM, ilp, variables, obj);
+        StratifiedConstraint::ForEachComposition(currentM, f);
 }
 
-
-void PropAprimeConstraint::Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-) const
+void PropAprimeConstraint::ForEachComposition(unsigned int currentM, const CompositionCallback& f) const
 {
     if (currentM == 2 * dims.size()) 
-        StratifiedConstraint::Apply(matrices, gf, currentM, ilp, variables, obj);
+        StratifiedConstraint::ForEachComposition(currentM, f);
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <random>
+#include <functional>
+#include <map>
+#include <set>
 #include "ILP/ILP_def.hpp"
 #include "utils/GFMatrix.hpp"
 #include <vector>
@@ -27,23 +30,73 @@ public:
         return new T(modifier, dimList, opts);
     }
 
+    using CompositionCallback = std::function<void(const std::vector<int>& k)>;
+
+    // Linear form over GF(q), as (variable, coefficient) sorted by variable
+    using GFRow = std::vector<std::pair<uint32_t, int>>;
+
+    // Calls f with every row split k (k[i] rows taken from dims[i]) the 
+    // constraint requires at currentM. Modifier range is not checked here.
+    virtual void ForEachComposition(unsigned int currentM, const CompositionCallback& f) const = 0;
+
+    // Adds the rows required at currentM. If forms is not null, the determinant
+    // of each emitted row is also appended to it.
     virtual void Apply(
         const std::vector<GFMatrix>& matrices,
         const Galois::Field& gf,  
         unsigned int currentM, 
 
-        ILP& ilp, const Var* variables, Exp& obj
-    ) const = 0;
+        ILP& ilp, const Var* variables, Exp& obj, 
+        std::vector<GFRow>* forms = nullptr
+    ) const;
+
+    // Smallest number of leading columns making one of the compositions at currentM 
+    // singular whatever the next columns are. 0 if there is none.
+    int DependentPrefix(
+        const std::vector<GFMatrix>& matrices,
+        const Galois::Field& gf,  
+        unsigned int currentM
+    ) const;
+
+    // Adds an upper bound on what Apply creates at currentM, without computing determinants:
+    // identical rows, emitted once by Apply, are all counted.
+    void EstimateSize(unsigned int currentM, int q, ilp::ModelSize& size) const;
+
+    // True if every composition at currentM is non singular in the given matrices
+    bool Check(
+        const std::vector<GFMatrix>& matrices,
+        const Galois::Field& gf,  
+        unsigned int currentM
+    ) const;
+
+    bool IsActive(unsigned int currentM) const
+    { return int(currentM) >= modifier.minM && int(currentM) <= modifier.maxM; }
 
     const Modifier& GetModifier() const
     { return modifier; }
 
-    // virtual void Check() const = 0;
+    const std::vector<int>& GetDims() const
+    { return dims; }
+
+    // Composition at currentM required by another constraint, so Apply leaves it out
+    void Skip(unsigned int currentM, const std::vector<int>& k)
+    { skipped[currentM].insert(k); }
+
+    size_t SkippedCount(unsigned int currentM) const
+    {
+        auto it = skipped.find(currentM);
+        return it == skipped.end() ? 0 : it->second.size();
+    }
 
     virtual ~Constraint() {}
 protected:
+    // Matrices of the dimensions of the constraint, in order (views, nothing is copied)
+    std::vector<GFMatrixView> SelectMatrices(const std::vector<GFMatrix>& matrices) const;
+
     Modifier modifier;
     std::vector<int> dims;
+
+    std::map<unsigned int, std::set<std::vector<int>>> skipped;
 };
 
 class ZeroNetConstraint : public Constraint
@@ -64,13 +117,7 @@ public:
         }
     }
 
-    virtual void Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-    ) const;
+    virtual void ForEachComposition(unsigned int currentM, const CompositionCallback& f) const;
 public:
     int max_unblance;
 };
@@ -82,13 +129,7 @@ public:
         Constraint(modifier, dimList)
     {  }
 
-    virtual void Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-    ) const;
+    virtual void ForEachComposition(unsigned int currentM, const CompositionCallback& f) const;
 private:
 };
 
@@ -99,13 +140,7 @@ public:
         StratifiedConstraint(modifier, dimList, opts)
     {  }
 
-    virtual void Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-    ) const;
+    virtual void ForEachComposition(unsigned int currentM, const CompositionCallback& f) const;
 private:
 };
 
@@ -116,12 +151,6 @@ public:
         StratifiedConstraint(modifier, dimList, opts)
     {  }
 
-    virtual void Apply(
-        const std::vector<GFMatrix>& matrices, 
-        const Galois::Field& gf, 
-        unsigned int currentM, 
-
-        ILP& ilp, const Var* variables, Exp& obj
-    ) const;
+    virtual void ForEachComposition(unsigned int currentM, const CompositionCallback& f) const;
 private:
 };
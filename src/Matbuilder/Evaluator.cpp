@@ -0,0 +1,178 @@
+#include "Evaluator.hpp"
+
+#include <algorithm>
+
+static int Parity(uint64_t word)
+{
+#if defined(__GNUC__)
+    return __builtin_parityll(word);
+#else
+    word ^= word >> 32; word ^= word >> 16; word ^= word >> 8;
+    word ^= word >> 4;  word ^= word >> 2;  word ^= word >> 1;
+    return int(word & 1);
+#endif
+}
+
+ColumnEvaluator::ColumnEvaluator(const Galois::Field& gf, uint32_t varCount,
+                                 const std::vector<Constraint::GFRow>& rows,
+                                 const std::vector<bool>& hard, const std::vector<int>& weights) :
+    q(gf.q), prime(GF::IsPrime(gf.q)), varCount(varCount), rowCount(rows.size()), hard(hard), weights(weights)
+{
+    for (uint32_t r = 0; r < rowCount; r++) weak = weak || !hard[r];
+
+    if (q == 2)
+    {
+        wordCount = (varCount + 63) / 64;
+        bits.assign(size_t(rowCount) * wordCount, 0);
+        for (uint32_t r = 0; r < rowCount; r++)
+            for (const auto& coeff : rows[r])
+                if (coeff.second % 2) bits[r * wordCount + coeff.first / 64] |= uint64_t(1) << (coeff.first % 64);
+        return;
+    }
+
+    coefs.assign(size_t(rowCount) * varCount, 0);
+    for (uint32_t r = 0; r < rowCount; r++)
+        for (const auto& coeff : rows[r])
+            coefs[size_t(r) * varCount + coeff.first] = GFElement(coeff.second);
+
+    if (!prime && q > GF::LargeBase)
+    {
+        logField = &GF::GetLogField(gf);
+    }
+    else if (!prime)
+    {
+        addTable.resize(q * q);
+        mulTable.resize(q * q);
+        for (int a = 0; a < q; a++)
+        {
+            for (int b = 0; b < q; b++)
+            {
+                addTable[a * q + b] = GFElement(gf.plus(a, b));
+                mulTable[a * q + b] = GFElement(gf.times(a, b));
+            }
+        }
+    }
+}
+
+int ColumnEvaluator::RowBits(uint32_t r, const std::vector<uint64_t>& column) const
+{
+    const uint64_t* row = bits.data() + size_t(r) * wordCount;
+    uint64_t acc = 0;
+    for (uint32_t w = 0; w < wordCount; w++) acc ^= row[w] & column[w];
+    return Parity(acc);
+}
+
+int ColumnEvaluator::Row(uint32_t r, const std::vector<int>& column) const
+{
+    const GFElement* row = coefs.data() + size_t(r) * varCount;
+    if (prime)
+    {
+        // Products are below q^2, sums are reduced before they can overflow
+        const uint64_t square = uint64_t(q - 1) * uint64_t(q - 1);
+        const uint64_t chunk = std::max<uint64_t>(1, (UINT64_MAX - q) / square);
+        uint64_t det = 0;
+        for (uint64_t start = 0; start < varCount; start += chunk)
+        {
+            const uint32_t end = uint32_t(std::min<uint64_t>(varCount, start + chunk));
+            uint64_t acc = det;
+            for (uint32_t i = uint32_t(start); i < end; i++) acc += uint64_t(row[i]) * uint64_t(column[i]);
+            det = acc % q;
+        }
+        return int(det);
+    }
+
+    int det = 0;
+    if (logField)
+    {
+        for (uint32_t i = 0; i < varCount; i++)
+            if (row[i]) det = logField->plus(det, logField->times(row[i], column[i]));
+        return det;
+    }
+    for (uint32_t i = 0; i < varCount; i++)
+        if (row[i]) det = addTable[det * q + mulTable[row[i] * q + column[i]]];
+    return det;
+}
+
+uint64_t ColumnEvaluator::RowSliced(uint32_t r, const std::vector<uint64_t>& slices) const
+{
+    const uint64_t* row = bits.data() + size_t(r) * wordCount;
+    uint64_t acc = 0;
+    for (uint32_t w = 0; w < wordCount; w++)
+    {
+        uint64_t word = row[w];
+        while (word)
+        {
+            const int bit = GF::CountTrailingZeros(word);
+            acc ^= slices[w * 64 + bit];
+            word &= word - 1;
+        }
+    }
+    return acc;
+}
+
+void ColumnEvaluator::Accumulate(Result& result, uint32_t r, int det) const
+{
+    if (hard[r])
+    {
+        if (det == 0) result.firstViolated = r;
+    }
+    else if (det != 0)
+    {
+        result.weakScore += weights[r];
+    }
+}
+
+ColumnEvaluator::Result ColumnEvaluator::Evaluate(const std::vector<int>& column) const
+{
+    Result result;
+    if (q == 2)
+    {
+        std::vector<uint64_t> packed(wordCount, 0);
+        for (uint32_t i = 0; i < varCount; i++)
+            if (column[i] & 1) packed[i / 64] |= uint64_t(1) << (i % 64);
+
+        for (uint32_t r = 0; r < rowCount && result.Valid(); r++)
+            Accumulate(result, r, RowBits(r, packed));
+        return result;
+    }
+
+    for (uint32_t r = 0; r < rowCount && result.Valid(); r++)
+        Accumulate(result, r, Row(r, column));
+    return result;
+}
+
+std::vector<ColumnEvaluator::Result> ColumnEvaluator::Evaluate(const std::vector<std::vector<int>>& columns) const
+{
+    std::vector<Result> results(columns.size());
+    if (q != 2)
+    {
+        for (uint32_t c = 0; c < columns.size(); c++) results[c] = Evaluate(columns[c]);
+        return results;
+    }
+
+    // Candidates by groups of 64, slice i holds the value of variable i for each of them
+    std::vector<uint64_t> slices(size_t(wordCount) * 64, 0);
+    for (size_t first = 0; first < columns.size(); first += 64)
+    {
+        const size_t count = std::min<size_t>(64, columns.size() - first);
+        std::fill(slices.begin(), slices.end(), 0);
+        for (size_t c = 0; c < count; c++)
+            for (uint32_t i = 0; i < varCount; i++)
+                if (columns[first + c][i] & 1) slices[i] |= uint64_t(1) << c;
+
+        uint64_t alive = (count == 64) ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+        for (uint32_t r = 0; r < rowCount && alive; r++)
+        {
+            const uint64_t dets = RowSliced(r, slices);
+            uint64_t marked = hard[r] ? (alive & ~dets) : (alive & dets);
+            while (marked)
+            {
+                const int c = GF::CountTrailingZeros(marked);
+                Accumulate(results[first + c], r, hard[r] ? 0 : 1);
+                marked &= marked - 1;
+            }
+            if (hard[r]) alive &= dets;
+        }
+    }
+    return results;
+}
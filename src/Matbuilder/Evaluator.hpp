@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <galois++/field.h>
+
+#include "Constraints.hpp"
+#include "utils/GFArithmetic.hpp"
+
+// Evaluates candidate columns (values of the x variables of a step) on the determinant
+// rows of the step, without going through a backend.
+//
+// Rows are stored densely: one bit per variable in base 2, where 64 candidates are
+// evaluated at once (one candidate per bit, parity of the xor of the row variables),
+// and one GFElement per variable otherwise (dot products reduced mod p, or GF tables when
+// q is a prime power, logarithm tables above GF::LargeBase).
+class ColumnEvaluator
+{
+public:
+    struct Result
+    {
+        // First hard row with a zero determinant, -1 if all are non zero
+        int firstViolated = -1;
+        // Sum of the weights of weak rows with a non zero determinant
+        long long weakScore = 0;
+
+        bool Valid() const { return firstViolated < 0; }
+    };
+
+    // weights[r] is the weak weight of row r, hard[r] whether it must be non zero
+    ColumnEvaluator(const Galois::Field& gf, uint32_t varCount,
+                    const std::vector<Constraint::GFRow>& rows,
+                    const std::vector<bool>& hard, const std::vector<int>& weights);
+
+    Result Evaluate(const std::vector<int>& column) const;
+    std::vector<Result> Evaluate(const std::vector<std::vector<int>>& columns) const;
+
+    uint32_t RowCount() const { return rowCount; }
+    bool HasWeakRows() const { return weak; }
+private:
+    // Determinant of row r (base 2: packed column bits)
+    int Row(uint32_t r, const std::vector<int>& column) const;
+    int RowBits(uint32_t r, const std::vector<uint64_t>& bits) const;
+
+    // Up to 64 candidates, bit c of the result is the determinant of row r for candidate c
+    uint64_t RowSliced(uint32_t r, const std::vector<uint64_t>& slices) const;
+
+    void Accumulate(Result& result, uint32_t r, int det) const;
+
+    int q;
+    bool prime;
+    bool weak = false;
+    uint32_t varCount;
+    uint32_t rowCount;
+
+    std::vector<bool> hard;
+    std::vector<int> weights;
+
+    // Base 2, row r is words [r * wordCount, (r + 1) * wordCount)
+    uint32_t wordCount = 0;
+    std::vector<uint64_t> bits;
+    // Other bases, row r is [r * varCount, (r + 1) * varCount)
+    std::vector<GFElement> coefs;
+
+    // Prime powers
+    std::vector<GFElement> addTable;
+    std::vector<GFElement> mulTable;
+    const GF::LogField* logField = nullptr;
+};
@@ -1,6 +1,8 @@
 #include "Parser.hpp"
 
 #include <fstream>
+#include <set>
+#include <algorithm>
 
 inline void trim(std::string& tmp)
 {
@@ -67,6 +69,7 @@ MatbuilderProgram Parser::Parse(const std::string& filename) const
                 std::cerr << "Error: can not parse p value or p < 2 (" << tmp << ")" << std::endl;
                 return program;
             }
+            if (!ValidateBase(program.p)) return program;
         }
         else if (program.m == 0 && tmp[0] == 'm') // Numbers to generate
         {
@@ -143,4 +146,75 @@ MatbuilderProgram Parser::Parse(const std::string& filename) const
     }
     program.is_valid = (program.s >= 1) && (program.m > 0) && (program.p > 1);
     return program;
-}
\ No newline at end of file
+}
+
+void RemoveImpliedConstraints(MatbuilderProgram& program, std::ostream& report)
+{
+    const int nbConstraints = program.constraints.size();
+    std::vector<size_t> total(nbConstraints, 0), implied(nbConstraints, 0);
+    std::vector<bool> useless(nbConstraints, true);
+
+    // A shared instance is kept by the hard constraint with the smallest last dimension
+    // (the first one to apply when solving dimensions incrementally), then the first one.
+    std::vector<int> order(nbConstraints);
+    for (int c = 0; c < nbConstraints; c++) order[c] = c;
+    auto maxDim = [&](int c) {
+        const auto& dims = program.constraints[c]->GetDims();
+        return *std::max_element(dims.begin(), dims.end());
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return maxDim(a) < maxDim(b); });
+
+    for (int m = 1; m <= program.m; m++)
+    {
+        // Rows taken from each dimension, as sorted (dimension, rows) pairs
+        std::set<std::vector<std::pair<int, int>>> required;
+
+        // Hard constraints first, then weak ones are checked against them
+        for (int pass = 0; pass < 2; pass++)
+        {
+            for (int c : order)
+            {
+                Constraint* constraint = program.constraints[c];
+                if (constraint->GetModifier().weak != (pass == 1) || !constraint->IsActive(m)) continue;
+
+                const auto& dims = constraint->GetDims();
+                size_t count = 0;
+                constraint->ForEachComposition(m, [&](const std::vector<int>& k) {
+                    std::vector<std::pair<int, int>> key;
+                    for (unsigned int i = 0; i < k.size(); i++)
+                        if (k[i] > 0) key.push_back({dims[i], k[i]});
+                    std::sort(key.begin(), key.end());
+                    
+                    count++;
+                    if (pass == 0 ? !required.insert(key).second : required.count(key) > 0)
+                        constraint->Skip(m, k);
+                });
+
+                total[c] += count;
+                implied[c] += constraint->SkippedCount(m);
+                if (constraint->SkippedCount(m) < count) useless[c] = false;
+            }
+        }
+    }
+
+    std::vector<Constraint*> kept;
+    for (int c = 0; c < nbConstraints; c++)
+    {
+        if (total[c] == 0)
+        {
+            report << "Constraint " << c << " is never active, removed\n";
+        }
+        else if (implied[c] > 0)
+        {
+            report << "Constraint " << c << " (dims";
+            for (int d : program.constraints[c]->GetDims()) report << ' ' << d;
+            report << "): " << implied[c] << " of " << total[c] << " instances implied";
+            if (useless[c]) report << ", removed";
+            report << '\n';
+        }
+
+        if (useless[c]) delete program.constraints[c];
+        else kept.push_back(program.constraints[c]);
+    }
+    program.constraints = kept;
+}
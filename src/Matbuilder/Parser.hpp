@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <iostream>
 #include "Constraints.hpp"
 
 using CreateConstraint = 
@@ -18,6 +19,11 @@ struct MatbuilderProgram
     }
 };
 
+// Leaves out the instances (m, composition) of constraints already required by a hard 
+// constraint: on the same rows of the same dimensions, the determinant is the same up to sign.
+// Constraints left without instances are removed. What was removed is written to report.
+void RemoveImpliedConstraints(MatbuilderProgram& program, std::ostream& report);
+
 class Parser
 {
 public:
@@ -1,44 +1,125 @@
 #include "Solver.hpp"
+#include "Evaluator.hpp"
+#include "Checkpoint.hpp"
+#include "StreamLog.hpp"
 #include <chrono>
+#include <thread>
+#include <atomic>
 
-Exp Solver::GetRandomObjective(ILP& ilp, const std::vector<Var>& variables, int q)
+Exp Solver::GetRandomObjective(ILP& ilp, const std::vector<Var>& variables, const std::vector<bool>& used, int q, std::vector<int>* targets)
 {
     Exp obj = ilp.CreateOperation();
+    if (targets) targets->assign(variables.size(), -1);
 
-    if (!params.randomObjective) return obj;
+    if (!params.randomObjective) 
+    {
+        for (unsigned int i = 0; i < variables.size(); i++)
+        {
+            const auto& bounds = ilp.GetVariablesBounds()[variables[i].id];
+            if (!used[i] && bounds.first != bounds.second) ilp.SetBounds(variables[i].id, 0, 0);
+        }
+        return obj;
+    }
+
+    const ObjectiveEncoding encoding = backend ? backend->GetObjectiveEncoding() : ObjectiveEncoding::Compact;
 
     std::uniform_int_distribution<int> dist(0, q - 1);
     for (unsigned int i = 0; i < variables.size(); i++)
     {
-        // Replace min |A - B|
-        // By:
-        //      min X'
-        //      st A - B <= X'
-        //         B - A <= X'  
+        const auto& bounds = ilp.GetVariablesBounds()[variables[i].id];
+        if (bounds.first == bounds.second) continue;
 
         int c = dist(params.rng);
+        if (targets) (*targets)[i] = c;
+
+        if (!used[i])
+        {
+            // Only in the objective, so its optimal value is known
+            ilp.SetBounds(variables[i].id, c, c);
+        }
+        else if (encoding == ObjectiveEncoding::Auxiliary)
+        {
+            // Replace min |A - B|
+            // By:
+            //      min X'
+            //      st A - B <= X'
+            //         B - A <= X'  
 
-        Var xp = ilp.CreateVariable("O");
-        obj = obj + xp;
+            Var xp = ilp.CreateVariable("O");
+            obj = obj + xp;
 
-        ilp.AddConstraint("OBJL", variables[i] - c <= xp);
-        ilp.AddConstraint("OBJH", c - variables[i] <= xp);
+            ilp.AddConstraint("OBJL", variables[i] - c <= xp);
+            ilp.AddConstraint("OBJH", c - variables[i] <= xp);
+        }
+        // Constants are dropped, they do not change the optimum
+        else if (c == 0)
+        {
+            // |x - 0| = x
+            obj = obj + variables[i];
+        }
+        else if (c == q - 1)
+        {
+            // |x - (q - 1)| = (q - 1) - x
+            obj = obj + (-1) * variables[i];
+        }
+        else
+        {
+            // |x - c| = x - c + 2 max(0, c - x)
+            // With:
+            //      min x + 2 X'
+            //      st c - x <= X', 0 <= X' <= c
+
+            Var xp = ilp.CreateVariable("O", 0, c);
+            obj = obj + variables[i] + 2 * xp;
+
+            ilp.AddConstraint("OBJ", c - variables[i] <= xp);
+        }
     }
 
     return obj;
 }
 
-ILP Solver::GetILP(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int m)
+const Galois::Field& Solver::GetField(int p)
 {
-    const Galois::Field gf(program.p);
+    if (!field || field->q != p) field.reset(new Galois::Field(p));
+    return *field;
+}
+
+ILP Solver::GetILP(
+    const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int m, StepInfo* info, 
+    int fixedDims, int nbDims)
+{
+    const Galois::Field& gf = GetField(program.p);
+    if (nbDims <= 0) nbDims = program.s;
 
     ILP ilp;
+    ilp.Reserve(EstimateILP(program, m, fixedDims, nbDims));
     Exp obj = ilp.CreateOperation();
 
     
-    const std::vector<Var> variables = ilp.CreateVariables("x", m * program.s, 0, gf.q - 1);
+    const std::vector<Var> variables = ilp.CreateVariables("x", m * nbDims, 0, gf.q - 1);
+    for (int k = 0; k < fixedDims; k++)
+        for (int i = 0; i < m; i++)
+            ilp.SetBounds(variables[i + k * m].id, matrices[k][i][m - 1], matrices[k][i][m - 1]);
+
     for (const auto& constraint : program.constraints)
-        constraint->Apply(matrices, gf, m, ilp, variables.data(), obj);
+    {
+        if (info) info->rowStart.push_back(ilp.GetConstraints().size());
+
+        // Constraints on fixed dimensions only are already satisfied
+        const auto& dims = constraint->GetDims();
+        const int maxDim = *std::max_element(dims.begin(), dims.end());
+        if (maxDim >= nbDims || maxDim < fixedDims) continue;
+
+        constraint->Apply(matrices, gf, m, ilp, variables.data(), obj, info ? &info->forms : nullptr);
+        if (info) info->formConstraint.resize(info->forms.size(), &constraint - program.constraints.data());
+    }
+    if (info) info->rowStart.push_back(ilp.GetConstraints().size());
+    if (info) 
+    {
+        info->xCount = variables.size();
+        info->fixedDims = fixedDims;
+    }
 
     // According to paper
     // obj = (program.s * program.m * (program.p - 1)) * obj;
@@ -54,70 +135,520 @@ ILP Solver::GetILP(const MatbuilderProgram& program, const std::vector<GFMatrix>
         }
     }
 
-    ilp.SetObjective(obj + GetRandomObjective(ilp, variables, program.p));
+    std::vector<bool> used(variables.size(), false);
+    for (const auto& row : ilp.GetConstraints())
+        for (const auto& coeff : row.coefs.Get())
+            if (coeff.first < variables.size()) used[coeff.first] = true;
+
+    ilp.SetObjective(obj + GetRandomObjective(ilp, variables, used, program.p, info ? &info->targets : nullptr));
+
+    // Slack variables (k) are created without upper bound
+    if (info) info->bounds = ilp.GetVariablesBounds();
+    ilp.TightenBounds();
 
     return ilp;
 }
 
+std::vector<int> Solver::SampleColumn(const MatbuilderProgram& program, const ILP& ilp, const StepInfo& info, const std::vector<NoGood>& nogoods)
+{
+    const auto& bounds = ilp.GetVariablesBounds();
+
+    std::vector<bool> hard(info.forms.size());
+    std::vector<int> weights(info.forms.size());
+    for (uint32_t r = 0; r < info.forms.size(); r++)
+    {
+        const auto& modifier = program.constraints[info.formConstraint[r]]->GetModifier();
+        hard[r] = !modifier.weak;
+        weights[r] = modifier.weakWeight;
+    }
+    const ColumnEvaluator evaluator(GetField(program.p), info.xCount, info.forms, hard, weights);
+
+    std::vector<int> best;
+    long long bestScore = 0;
+    for (int first = 0; first < params.samples; first += 64)
+    {
+        std::vector<std::vector<int>> columns(std::min(64, params.samples - first), std::vector<int>(info.xCount));
+        for (uint32_t c = 0; c < columns.size(); c++)
+        {
+            for (uint32_t i = 0; i < info.xCount; i++)
+            {
+                // Bounds are tightened, fixed variables have a single value
+                if (first + c == 0 && info.targets[i] >= 0) columns[c][i] = info.targets[i];
+                else columns[c][i] = std::uniform_int_distribution<int>(bounds[i].first, bounds[i].second)(params.rng);
+            }
+        }
+
+        const auto results = evaluator.Evaluate(columns);
+        for (uint32_t c = 0; c < columns.size(); c++)
+        {
+            if (!results[c].Valid() || IsExcluded(columns[c], nogoods)) continue;
+
+            if (!evaluator.HasWeakRows()) return columns[c];
+            if (best.empty() || results[c].weakScore > bestScore)
+            {
+                best = columns[c];
+                bestScore = results[c].weakScore;
+            }
+        }
+    }
+    return best;
+}
+
+ilp::ModelSize Solver::EstimateILP(const MatbuilderProgram& program, int m, int fixedDims, int nbDims) const
+{
+    if (nbDims <= 0) nbDims = program.s;
+
+    ilp::ModelSize size;
+    size.variables = m * nbDims;
+
+    // Same selection as GetILP
+    for (const auto& constraint : program.constraints)
+    {
+        const auto& dims = constraint->GetDims();
+        const int maxDim = *std::max_element(dims.begin(), dims.end());
+        if (maxDim >= nbDims || maxDim < fixedDims) continue;
+
+        constraint->EstimateSize(m, program.p, size);
+    }
+
+    // Seed objective, at most one variable per x (none in base 2)
+    const uint64_t free = m * (nbDims - fixedDims);
+    const ObjectiveEncoding encoding = backend ? backend->GetObjectiveEncoding() : ObjectiveEncoding::Compact;
+    if (!params.randomObjective) {}
+    else if (encoding == ObjectiveEncoding::Auxiliary)
+    {
+        size.variables += free;
+        size.rows      += 2 * free;
+        size.nonZeros  += 4 * free;
+    }
+    else if (program.p > 2)
+    {
+        size.variables += free;
+        size.rows      += free;
+        size.nonZeros  += 2 * free;
+    }
+    return size;
+}
+
+std::vector<std::vector<int>> Solver::SolveDecomposed(const ILP& ilp, uint32_t keyCount) const
+{
+    std::vector<std::vector<uint32_t>> vars, rows;
+    const std::vector<ILP> parts = ilp.Components(vars, rows);
+
+    if (parts.size() <= 1)
+        return backend->SolveILPPool(ilp, keyCount, params.poolSize);
+
+    // Parts share the threads given to the backend: each solve gets its share
+    const uint32_t budget = (backend->GetThreads() > 0) ? backend->GetThreads() : std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t nbThreads = std::min<uint32_t>(parts.size(), budget);
+    const std::unique_ptr<Backend> shared = backend->IsThreadSafe() ? backend->WithThreads(std::max(1u, budget / nbThreads)) : nullptr;
+    const Backend* partBackend = shared ? shared.get() : backend;
+
+    // Keys are the first variables, and parts keep the order of variables
+    std::vector<std::vector<std::vector<int>>> pools(parts.size());
+    auto solvePart = [&](uint32_t c) {
+        const uint32_t keys = std::lower_bound(vars[c].begin(), vars[c].end(), keyCount) - vars[c].begin();
+        pools[c] = partBackend->SolveILPPool(parts[c], keys, params.poolSize);
+    };
+
+    if (shared && nbThreads > 1)
+    {
+        std::atomic<uint32_t> next(0);
+        std::vector<std::thread> workers;
+        for (uint32_t t = 0; t < nbThreads; t++)
+        {
+            workers.emplace_back([&]() {
+                for (uint32_t c = next++; c < parts.size(); c = next++) solvePart(c);
+            });
+        }
+        for (auto& worker : workers) worker.join();
+    }
+    else
+    {
+        for (uint32_t c = 0; c < parts.size(); c++)
+        {
+            solvePart(c);
+            if (pools[c].empty()) break;
+        }
+    }
+
+    for (uint32_t c = 0; c < parts.size(); c++)
+        if (pools[c].empty()) return {};
+
+    // Best solution of every part, then alternatives of one part at a time
+    std::vector<int> best(ilp.GetVariableNames().size());
+    for (uint32_t c = 0; c < parts.size(); c++)
+        for (uint32_t i = 0; i < vars[c].size(); i++)
+            best[vars[c][i]] = pools[c][0][i];
+
+    std::vector<std::vector<int>> pool = { best };
+    for (uint32_t c = 0; c < parts.size(); c++)
+    {
+        for (uint32_t k = 1; k < pools[c].size() && pool.size() < uint32_t(params.poolSize); k++)
+        {
+            pool.push_back(best);
+            for (uint32_t i = 0; i < vars[c].size(); i++)
+                pool.back()[vars[c][i]] = pools[c][k][i];
+        }
+    }
+    return pool;
+}
+
+bool Solver::IsExcluded(const std::vector<int>& values, const std::vector<NoGood>& nogoods)
+{
+    for (const auto& nogood : nogoods)
+    {
+        bool same = true;
+        for (unsigned int i = 0; i < nogood.first.size() && same; i++)
+            same = (values[nogood.first[i]] == nogood.second[i]);
+
+        if (same) return true;
+    }
+    return false;
+}
+
+int Solver::Backjump(
+    const MatbuilderProgram& program, const std::vector<GFMatrix>& result, int m, 
+    const ILP& ilp, const StepInfo& info, const std::vector<uint32_t>& conflict, NoGood& nogood)
+{
+    const int nbConstraints = program.constraints.size();
+
+    // Map rows back to the constraint that emitted them. Other rows (no-goods) 
+    // only depend on the columns of the dimensions they exclude. 
+    std::vector<bool> involved(nbConstraints, false);
+    std::vector<bool> dims(program.s, false);
+    for (uint32_t row : conflict)
+    {
+        const int c = int(std::upper_bound(info.rowStart.begin(), info.rowStart.end(), row) - info.rowStart.begin()) - 1;
+        if (c >= 0 && c < nbConstraints) 
+        {
+            involved[c] = true;
+            for (int d : program.constraints[c]->GetDims()) dims[d] = true;
+        }
+        else
+        {
+            for (const auto& coeff : ilp.GetConstraints()[row].coefs.Get())
+                if (coeff.first < info.xCount) dims[coeff.first / m] = true;
+        }
+    }
+
+    // Whatever was involved only depends on the previous columns
+    int target = m - 1;
+
+    // A singular composition in the first columns makes every later step fail
+    const Galois::Field& gf = GetField(program.p);
+    for (int c = 0; c < nbConstraints; c++)
+    {
+        if (!involved[c] || program.constraints[c]->GetModifier().weak) continue;
+
+        const int prefix = program.constraints[c]->DependentPrefix(result, gf, m);
+        if (prefix > 0 && prefix < target)
+        {
+            target = prefix;
+            std::fill(dims.begin(), dims.end(), false);
+            for (int d : program.constraints[c]->GetDims()) dims[d] = true;
+        }
+    }
+
+    nogood = NoGood();
+    if (conflict.empty() || target < 1) return std::max(target, 1);
+
+    // Fixed dimensions can not change
+    for (int d = info.fixedDims; d < program.s; d++)
+    {
+        if (!dims[d]) continue;
+        for (int i = 0; i < target; i++)
+        {
+            nogood.first.push_back(i + d * target);
+            nogood.second.push_back(result[d][i][target - 1]);
+        }
+    }
+    return target;
+}
+
+void Solver::State::Reset(const MatbuilderProgram& program)
+{
+    std::vector<GFMatrix> matrices(program.s, GFMatrix(program.m));
+    for (int k = 0; k < program.s && k < int(result.size()); k++)
+    {
+        const int cols = (k < fixedDims) ? program.m : prefix;
+        for (int i = 0; i < program.m; i++)
+            for (int j = 0; j < cols; j++)
+                matrices[k][i][j] = result[k][i][j];
+    }
+
+    m = prefix + 1;
+    backtrackCounts = 0;
+    result = matrices;
+    candidates = std::vector<std::vector<std::vector<int>>>(program.m + 1);
+    nogoods = std::vector<std::vector<NoGood>>(program.m + 1);
+}
+
+void Solver::State::Init(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices)
+{
+    prefix = matrices.empty() ? 0 : matrices[0].size();
+    
+    result = std::vector<GFMatrix>(program.s, GFMatrix(program.m));
+    for (int k = 0; k < int(matrices.size()); k++)
+        for (int i = 0; i < prefix; i++)
+            for (int j = 0; j < prefix; j++)
+                result[k][i][j] = matrices[k][i][j];
+
+    Reset(program);
+}
+
+bool Solver::ValidateMatrices(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices)
+{
+    if (int(matrices.size()) != program.s)
+    {
+        std::cerr << "Error: matrix file does not have " << program.s << " dimensions" << std::endl;
+        return false;
+    }
+    return ::ValidateMatrices(matrices, program.p);
+}
+
+bool Solver::VerifyPrefix(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int m)
+{
+    const Galois::Field gf(program.p);
+
+    bool valid = true;
+    for (int currentM = 1; currentM <= m; currentM++)
+    {
+        for (unsigned int c = 0; c < program.constraints.size(); c++)
+        {
+            if (program.constraints[c]->GetModifier().weak) continue;
+            
+            if (!program.constraints[c]->Check(matrices, gf, currentM))
+            {
+                std::cerr << "Constraint " << c << " is not satisfied for m = " << currentM << std::endl;
+                valid = false;
+            }
+        }
+    }
+    return valid;
+}
+
+void Solver::AdvanceRNG(std::mt19937& rng, const MatbuilderProgram& program, int m)
+{
+    // Same sequence as matbuilder_expand, so that both tools agree on step m+1
+    rng.discard(program.s * (program.m * (program.m + 1)) / 2);
+    rng.discard(m * program.s);
+}
+
+void Solver::SaveCheckpoint(const State& state)
+{
+    Checkpoint checkpoint;
+    checkpoint.hash  = params.programHash;
+    checkpoint.seed  = params.seed;
+    checkpoint.rng   = params.rng;
+    checkpoint.state = state;
+
+    if (!checkpoint.Save(params.checkpointFile))
+        std::cerr << "Can not write checkpoint to " << params.checkpointFile << std::endl;
+}
+
+std::vector<GFMatrix> Solver::solveByDimensions(const MatbuilderProgram& program, int batch)
+{
+    State state;
+    state.result = std::vector<GFMatrix>(program.s, GFMatrix(program.m));
+
+    for (int first = 0; first < program.s; first += batch)
+    {
+        state.fixedDims = first;
+        state.nbDims = std::min(first + batch, program.s);
+        state.greedyFails = 0;
+        state.Reset(program);
+
+        std::cout << "Solving dimensions " << first << " to " << state.nbDims - 1 << std::endl;
+        solve(program, state);
+
+        if (state.greedyFails >= params.greedyFailMax)
+        {
+            std::cerr << "Dimensions " << first << " to " << state.nbDims - 1 << " could not be solved" << std::endl;
+            break;
+        }
+    }
+    return state.result;
+}
+
 std::vector<GFMatrix> Solver::solve(const MatbuilderProgram& program)
 {
-    std::vector<GFMatrix> result;
+    State state;
+    return solve(program, state);
+}
 
-    bool failed = true;
-    int greedyFails = 0;
+std::vector<GFMatrix> Solver::solve(const MatbuilderProgram& program, State& state)
+{
+    // A state with matrices is continued, otherwise it starts from scratch
+    bool resume = !state.result.empty();
+    auto lastCheckpoint = std::chrono::steady_clock::now();
     
-    while (failed && greedyFails < params.greedyFailMax)
+    while (state.greedyFails < params.greedyFailMax)
     {
-        result = std::vector<GFMatrix>(program.s, GFMatrix(program.m));
-     
-        int backtrackCounts = 0;
-        for (int m = 1; m <= program.m; m++)
+        if (!resume) state.Reset(program);
+        resume = false;
+
+        if (params.stream) params.stream->Restart(state.result, state.m - 1);
+        
+        bool failed = false;
+        for (int& m = state.m; m <= program.m; m++)
         {
+            auto& result = state.result;
+            auto& candidates = state.candidates;
+            auto& nogoods = state.nogoods;
+
+            auto start = std::chrono::steady_clock::now();
+            if (!params.checkpointFile.empty() && 
+                std::chrono::duration_cast<std::chrono::seconds>(start - lastCheckpoint).count() >= params.checkpointInterval)
+            {
+                SaveCheckpoint(state);
+                lastCheckpoint = start;
+            }
+
+            if (params.memoryBudget > 0)
+            {
+                const double needed = EstimateILP(program, m, state.fixedDims, state.nbDims).Bytes() / (1024. * 1024.);
+                if (needed > params.memoryBudget)
+                {
+                    // Backtracking would meet the same step again
+                    std::cerr << "Step m = " << m << " may need up to " << needed << " MB, over the memory budget" << std::endl;
+                    state.greedyFails = params.greedyFailMax;
+                    return state.result;
+                }
+            }
+
             int percentage = 100 * ((double) m / (double) program.m);
             std::cout << "Solving for m = " << m << " (" << percentage << "%)" << '\n';
 
-            ILP ilp = GetILP(program, result, m);
-            auto start = std::chrono::steady_clock::now();
-            auto values = backend->SolveILP(ilp);
+            std::vector<int> values;
+            while (values.empty() && !candidates[m].empty())
+            {
+                if (!IsExcluded(candidates[m].back(), nogoods[m])) 
+                    values = candidates[m].back();
+                candidates[m].pop_back();
+            }
+
+            ILP ilp;
+            StepInfo info;
+            std::vector<uint32_t> conflict;
+            if (!values.empty())
+            {
+                std::cout << "Using stored solution (" << candidates[m].size() << " left)" << '\n';
+            }
+            else
+            {
+                ilp = GetILP(program, result, m, &info, state.fixedDims, state.nbDims);
+                for (const auto& nogood : nogoods[m])
+                    ilp.AddNoGood("NG", nogood.first, nogood.second);
+
+                if (params.samples > 0)
+                {
+                    values = SampleColumn(program, ilp, info, nogoods[m]);
+                    if (!values.empty()) std::cout << "Random column accepted" << '\n';
+                }
+            }
+
+            if (values.empty() && ilp.GetVariableNames().size() > 0)
+            {
+                // Fixed variables are only sent as constants
+                std::vector<uint32_t> kept;
+                const ILP reduced = ilp.WithoutFixed(kept);
+
+                std::vector<int> full(ilp.GetVariableNames().size());
+                for (uint32_t i = 0; i < full.size(); i++) full[i] = ilp.GetVariablesBounds()[i].first;
+
+                std::vector<std::vector<int>> pool;
+                if (kept.empty())
+                {
+                    // Nothing left to solve 
+                    if (ilp.IsFeasible(full)) pool.push_back(full);
+                }
+                else
+                {
+                    const uint32_t keyCount = std::lower_bound(kept.begin(), kept.end(), info.xCount) - kept.begin();
+                    pool = SolveDecomposed(reduced, keyCount);
+                }
+
+                // Conflicts are only needed to backjump. Inferred bounds hide the rows they come
+                // from (fixed variables even leave them constant), so the program is searched 
+                // with the bounds it was built with.
+                if (pool.empty() && params.backjump && m > state.prefix + 1)
+                {
+                    ILP built = ilp;
+                    for (uint32_t i = 0; i < info.bounds.size(); i++)
+                        built.SetBounds(i, info.bounds[i].first, info.bounds[i].second);
+                    conflict = backend->FindConflict(built);
+                }
+
+                for (auto& solution : pool)
+                {
+                    if (solution.size() == full.size()) continue;
+                    for (uint32_t i = 0; i < kept.size(); i++) full[kept[i]] = solution[i];
+                    solution = full;
+                }
+                
+                if (!pool.empty())
+                {
+                    values = pool.front();
+                    // Stored in reverse order, so that best ones are popped first
+                    candidates[m].assign(pool.rbegin(), pool.rend() - 1);
+                }
+            }
 
             // Backtracking needed, no solution found ! 
             if (values.size() == 0)
             {
                 std::cout << "Solution not found... Backtracking" << std::endl;
-                backtrackCounts ++;
-                if (backtrackCounts > params.backtrackMax) 
+                state.backtrackCounts ++;
+                if (state.backtrackCounts > params.backtrackMax) 
                 {
-                    backtrackCounts = 0;
-                    greedyFails ++;
+                    state.greedyFails ++;
+                    failed = true;
                     break;
                 }
+
+                // Given columns are never solved again
+                const int first = state.prefix + 1;
+
+                int target = std::max(m - 1, first);
+                if (params.backjump && m > first)
+                {
+                    NoGood nogood;
+                    target = Backjump(program, result, m, ilp, info, conflict, nogood);
+                    if (target < first) target = first;
+                    else if (!nogood.first.empty()) nogoods[target].push_back(nogood);
+
+                    std::cout << "Backjumping to m = " << target << std::endl;
+                }
                 
-                     if (m >= 3) m -= 2;
-                else if (m == 2) m  = 0;
-                else if (m == 1) m  = 0;
-        
+                if (params.stream) params.stream->Retract(target);
+                m = target - 1;
                 continue;
             }
             
-            for (unsigned int k = 0; k < result.size(); k++)
+            // Stored solutions of next steps were computed for the previous column
+            for (int l = m + 1; l <= program.m; l++) 
+            {
+                candidates[l].clear();
+                nogoods[l].clear();
+            }
+
+            for (int k = state.fixedDims; k < state.Dims(program); k++)
             {
                 for (int i = 0; i < m; i++)
                 {
                     result[k][i][m - 1] = values[i + k * m];
                 }
             }
+            if (params.stream) params.stream->Accept(m, result);
+
             auto end = std::chrono::steady_clock::now();
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
             std::cout << "=== done ===> " <<elapsed.count() << " milliseconds." << std::endl;
         }
 
-        failed = false;
-    }
-    
-    if (failed)
-    {
-        return result;
+        if (!failed) break;
     }
 
-    return result;
+    return state.result;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <random>
+#include <memory>
 
 #include "utils/GFMatrix.hpp"
 #include "ILP/ILP_def.hpp"
@@ -9,6 +10,8 @@
 
 #include "ILP/backends/Backend.hpp"
 
+class StreamLog;
+
 class Solver
 {
 public:
@@ -19,22 +22,144 @@ public:
 
         std::mt19937 rng;
         bool randomObjective;
+
+        // Number of solutions asked to the backend for each step.
+        // Extra ones are kept to be used when backtracking to this step.
+        int poolSize = 1;
+
+        // On failure, analyse the conflict to backtrack directly 
+        // to the column responsible for it
+        bool backjump = false;
+
+        // State is periodically saved to checkpointFile (if not empty), so that 
+        // the run can be resumed. Hash and seed identify the run.
+        std::string checkpointFile;
+        int checkpointInterval = 600; // In seconds
+        uint64_t programHash = 0;
+        int seed = 0;
+
+        // Accepted and discarded columns are logged as soon as known
+        StreamLog* stream = nullptr;
+
+        // Steps whose program may use more memory (in MB, upper bound) stop the run, 0 for no limit
+        double memoryBudget = 0;
+
+        // Random columns tried before calling the backend (the seed targets first), 0 to disable
+        int samples = 0;
+    };
+
+    // Information on how the program of a step was built
+    struct StepInfo
+    {
+        // First row emitted by each constraint, followed by the number of constraint rows
+        std::vector<uint32_t> rowStart;
+        // The first xCount variables are the x of the solved dimensions, 
+        // those of the first fixedDims dimensions are fixed
+        uint32_t xCount = 0;
+        int fixedDims = 0;
+
+        // Determinant of each row emitted by constraints, and the constraint of each
+        std::vector<Constraint::GFRow> forms;
+        std::vector<int> formConstraint;
+        // Seed target of each x, -1 without seed objective
+        std::vector<int> targets;
+        // Variable bounds before TightenBounds
+        std::vector<std::pair<int, int>> bounds;
+    };
+
+    // Variables and values of a column that must not be chosen again
+    using NoGood = std::pair<std::vector<uint32_t>, std::vector<int>>;
+
+    // Everything solve needs to continue a run, apart from the RNG
+    struct State
+    {
+        int m = 1; // Next step to solve
+        int greedyFails = 0;
+        int backtrackCounts = 0;
+        
+        // Number of given columns, never solved again
+        int prefix = 0;
+
+        // Only dimensions below nbDims are solved (all if 0), 
+        // those below fixedDims are given and stay fixed
+        int fixedDims = 0;
+        int nbDims = 0;
+
+        std::vector<GFMatrix> result;
+        // Unused solutions of each step, valid as long as the previous columns do not change
+        std::vector<std::vector<std::vector<int>>> candidates;
+        // Columns known to fail for each step, under the same condition
+        std::vector<std::vector<NoGood>> nogoods;
+
+        // Back to the first step after the prefix
+        void Reset(const MatbuilderProgram& program);
+
+        int Dims(const MatbuilderProgram& program) const { return nbDims > 0 ? nbDims : program.s; }
+
+        // Starts after the columns of the given matrices
+        void Init(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices);
     };
 
     Solver(const SolverParams& params, Backend* backend) :
         params(params), backend(backend) 
     { }
 
-    ILP GetILP(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int m);
+    // Program of step m. Only constraints on dimensions below nbDims (all if 0) are used, 
+    // and x of dimensions below fixedDims are fixed to their value in matrices
+    ILP GetILP(
+        const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int m, StepInfo* info = nullptr, 
+        int fixedDims = 0, int nbDims = 0);
+
+    // Upper bound on the size of the program GetILP builds for step m (before no-goods): 
+    // identical rows, x left out of the sent program and compact seed targets are counted
+    ilp::ModelSize EstimateILP(const MatbuilderProgram& program, int m, int fixedDims = 0, int nbDims = 0) const;
 
     std::vector<GFMatrix> solve(const MatbuilderProgram& program);
 
+    // Continues from state (starts again if it has no matrices)
+    std::vector<GFMatrix> solve(const MatbuilderProgram& program, State& state);
+
+    // Adds batch dimensions at a time, each time solving all their columns 
+    // with the matrices of previous dimensions fixed
+    std::vector<GFMatrix> solveByDimensions(const MatbuilderProgram& program, int batch);
+
+    // Checks count, size and values of matrices read for the program
+    static bool ValidateMatrices(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices);
+
+    // Checks that matrices satisfy every hard constraint up to m
+    static bool VerifyPrefix(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int m);
+
+    // Advances rng before solving from step m+1 with m given columns
+    static void AdvanceRNG(std::mt19937& rng, const MatbuilderProgram& program, int m);
+
 protected:
     SolverParams params;
     Backend* backend;
 
+    // Field of the program, built once instead of at every step
+    const Galois::Field& GetField(int p);
+    std::unique_ptr<Galois::Field> field;
+
+    // Variables in no row are not in the objective either: they are fixed to their target.
+    // Variables already fixed are left out (and draw no target).
+    Exp GetRandomObjective(ILP& ilp, const std::vector<Var>& variables, const std::vector<bool>& used, int q, std::vector<int>* targets);
+
+    // Column (x values) satisfying every hard row of the step, found by trying random ones. 
+    // Among those, the best for weak constraints. Empty if none was found.
+    std::vector<int> SampleColumn(const MatbuilderProgram& program, const ILP& ilp, const StepInfo& info, const std::vector<NoGood>& nogoods);
+
+    // Step to solve again after step m failed on the given conflict rows, and the no-good to add to it
+    int Backjump(
+        const MatbuilderProgram& program, const std::vector<GFMatrix>& result, int m, 
+        const ILP& ilp, const StepInfo& info, const std::vector<uint32_t>& conflict, NoGood& nogood);
+
+    // Solves the independent parts of ilp separately (at the same time if the backend allows it)
+    // and merges their solutions. Empty if one of them is infeasible.
+    std::vector<std::vector<int>> SolveDecomposed(const ILP& ilp, uint32_t keyCount) const;
+
+    void SaveCheckpoint(const State& state);
 
-    Exp GetRandomObjective(ILP& ilp, const std::vector<Var>& variables, int q);
+    static bool IsExcluded(const std::vector<int>& values, const std::vector<NoGood>& nogoods);
 
     
 };
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "StreamLog.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+static const std::string STREAM_MAGIC = "MBSL";
+static const int STREAM_VERSION = 2;
+
+static int BitsPerValue(int p)
+{
+    int bits = 1;
+    while ((1 << bits) < p) bits++;
+    return bits;
+}
+
+static bool ReadInt(std::istream& in, uint32_t& value, int bytes)
+{
+    value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        const int c = in.get();
+        if (c == EOF) return false;
+        value |= uint32_t(c) << (8 * i);
+    }
+    return true;
+}
+
+// Logs of version 1 (without 'P' records) are still read
+static bool ReadHeader(std::istream& in, uint32_t& s, uint32_t& m, uint32_t& p, int& version)
+{
+    std::string magic(STREAM_MAGIC.size(), '\0');
+    if (!in.read(&magic[0], magic.size()) || magic != STREAM_MAGIC) return false;
+    version = in.get();
+    if (version < 1 || version > STREAM_VERSION) return false;
+
+    return ReadInt(in, s, 4) && ReadInt(in, m, 4) && ReadInt(in, p, 4);
+}
+
+static int ColumnBytes(uint32_t s, uint32_t m, int bits)
+{
+    return (int(s * m) * bits + 7) / 8;
+}
+
+static int BlockBytes(uint32_t s, uint32_t m, int bits)
+{
+    return (int(s * m * m) * bits + 7) / 8;
+}
+
+static uint32_t Unpack(const std::string& data, int& pos, uint64_t& buffer, int& used, int bits)
+{
+    while (used < bits)
+    {
+        buffer |= uint64_t(uint8_t(data[pos++])) << used;
+        used += 8;
+    }
+    const uint32_t value = buffer & ((uint64_t(1) << bits) - 1);
+    buffer >>= bits;
+    used -= bits;
+    return value;
+}
+
+// Reads a whole record, false if it is incomplete or invalid
+static bool SkipRecord(std::istream& in, uint32_t s, uint32_t fullM, int bits)
+{
+    const int tag = in.get();
+    uint32_t m;
+    if (tag == EOF || !ReadInt(in, m, 2) || m < 1 || m > fullM) return false;
+    if (tag == 'R') return true;
+    if (tag != 'A' && tag != 'P') return false;
+
+    std::string data((tag == 'A') ? ColumnBytes(s, m, bits) : BlockBytes(s, m, bits), '\0');
+    return bool(in.read(&data[0], data.size()));
+}
+
+void StreamLog::WriteInt(uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        out.put(char((value >> (8 * i)) & 0xFF));
+}
+
+bool StreamLog::Open(const std::string& filename, const MatbuilderProgram& program)
+{
+    s = program.s;
+    bits = BitsPerValue(program.p);
+
+    bool append = false;
+    std::streamoff end = 0;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        uint32_t ls, lm, lp;
+        int version;
+        append = in.is_open() && ReadHeader(in, ls, lm, lp, version) && version == STREAM_VERSION &&
+                 ls == uint32_t(program.s) && lm == uint32_t(program.m) && lp == uint32_t(program.p);
+
+        // End of the last complete record
+        if (append)
+        {
+            end = in.tellg();
+            while (SkipRecord(in, ls, lm, bits)) end = in.tellg();
+        }
+    }
+
+    // A record cut by an interrupted writer would shift every record appended after it
+    if (append)
+    {
+        std::error_code error;
+        std::filesystem::resize_file(filename, end, error);
+        if (error) return false;
+    }
+
+    out.open(filename, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    if (!out.is_open()) return false;
+
+    if (!append)
+    {
+        out.write(STREAM_MAGIC.data(), STREAM_MAGIC.size());
+        out.put(char(STREAM_VERSION));
+        WriteInt(program.s, 4);
+        WriteInt(program.m, 4);
+        WriteInt(program.p, 4);
+        out.flush();
+    }
+    return out.good();
+}
+
+void StreamLog::Pack(uint32_t value, uint64_t& buffer, int& used)
+{
+    buffer |= uint64_t(value) << used;
+    used += bits;
+    while (used >= 8)
+    {
+        out.put(char(buffer & 0xFF));
+        buffer >>= 8;
+        used -= 8;
+    }
+}
+
+void StreamLog::Accept(int m, const std::vector<GFMatrix>& matrices)
+{
+    out.put('A');
+    WriteInt(m, 2);
+
+    uint64_t buffer = 0;
+    int used = 0;
+    for (int k = 0; k < s; k++)
+        for (int i = 0; i < m; i++)
+            Pack(matrices[k][i][m - 1], buffer, used);
+    if (used > 0) out.put(char(buffer & 0xFF));
+    out.flush();
+}
+
+void StreamLog::Retract(int m)
+{
+    out.put('R');
+    WriteInt(m, 2);
+    out.flush();
+}
+
+void StreamLog::Restart(const std::vector<GFMatrix>& matrices, int columns)
+{
+    Retract(1);
+    if (columns < 1) return;
+
+    // Initial matrices may have entries below the diagonal, that columns would not hold
+    out.put('P');
+    WriteInt(columns, 2);
+
+    uint64_t buffer = 0;
+    int used = 0;
+    for (int k = 0; k < s; k++)
+        for (int i = 0; i < columns; i++)
+            for (int j = 0; j < columns; j++)
+                Pack(matrices[k][i][j], buffer, used);
+    if (used > 0) out.put(char(buffer & 0xFF));
+    out.flush();
+}
+
+bool StreamLog::Read(const std::string& filename, std::vector<GFMatrix>& matrices)
+{
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    uint32_t s, fullM, p;
+    int version;
+    if (!ReadHeader(in, s, fullM, p, version)) return false;
+
+    const int bits = BitsPerValue(p);
+    std::vector<GFMatrix> result(s, GFMatrix(fullM));
+    int valid = 0;
+
+    int tag;
+    while ((tag = in.get()) != EOF)
+    {
+        uint32_t m;
+        if (!ReadInt(in, m, 2) || m < 1 || m > fullM) break;
+
+        if (tag == 'R')
+        {
+            valid = std::min(valid, int(m) - 1);
+            continue;
+        }
+        if (tag != 'A' && tag != 'P') break;
+
+        // Record is only applied once complete
+        const int bytes = (tag == 'A') ? ColumnBytes(s, m, bits) : BlockBytes(s, m, bits);
+        std::string data(bytes, '\0');
+        if (!in.read(&data[0], bytes)) break;
+
+        uint64_t buffer = 0;
+        int used = 0;
+        int pos = 0;
+        if (tag == 'P')
+        {
+            result.assign(s, GFMatrix(fullM));
+            for (uint32_t k = 0; k < s; k++)
+                for (uint32_t i = 0; i < m; i++)
+                    for (uint32_t j = 0; j < m; j++)
+                        result[k][i][j] = Unpack(data, pos, buffer, used, bits);
+            valid = m;
+            continue;
+        }
+
+        for (uint32_t k = 0; k < s; k++)
+            for (uint32_t i = 0; i < m; i++)
+                result[k][i][m - 1] = Unpack(data, pos, buffer, used, bits);
+
+        // A column invalidates the following ones, and is ignored if previous ones are missing
+        if (int(m) <= valid + 1) valid = m;
+    }
+
+    matrices = std::vector<GFMatrix>(s, GFMatrix(valid));
+    for (uint32_t k = 0; k < s; k++)
+        for (int i = 0; i < valid; i++)
+            for (int j = 0; j < valid; j++)
+                matrices[k][i][j] = result[k][i][j];
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "utils/GFMatrix.hpp"
+#include "Parser.hpp"
+
+// Append-only binary log of the columns accepted by the solver.
+//
+// Header : "MBSL", version (1 byte), s, m, p (4 bytes each)
+// Records: 'A', step (2 bytes), the step column of each matrix (rows 0 to step - 1),
+//               values packed on ceil(log2(p)) bits, padded to a byte
+//          'R', step (2 bytes): columns of steps >= step are no longer valid
+//          'P', steps (2 bytes), the whole steps x steps block of each matrix (row by row,
+//               packed as above): replaces every previous column (version 2)
+//
+// Integers are little endian. A record is flushed as soon as it is written,
+// and an incomplete last record (interrupted writer) is ignored by readers.
+class StreamLog
+{
+public:
+    // Appends to an existing log of the same program, after its last complete record
+    // (an incomplete one is removed), creates it otherwise
+    bool Open(const std::string& filename, const MatbuilderProgram& program);
+
+    // Step m has been solved, its column is stored in matrices
+    void Accept(int m, const std::vector<GFMatrix>& matrices);
+
+    // Steps m and above have been discarded
+    void Retract(int m);
+
+    // Clears the log and writes the first columns of matrices (with the rows below them,
+    // set by --init)
+    void Restart(const std::vector<GFMatrix>& matrices, int columns);
+
+    // Replays a log : matrices are the columns valid at its end (size of the prefix)
+    static bool Read(const std::string& filename, std::vector<GFMatrix>& matrices);
+private:
+    void WriteInt(uint32_t value, int bytes);
+    void Pack(uint32_t value, uint64_t& buffer, int& used);
+
+    std::ofstream out;
+    int s = 0;
+    int bits = 0;
+};
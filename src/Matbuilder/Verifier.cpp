@@ -0,0 +1,247 @@
+#include "Verifier.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    // Compositions of a constraint at m, one after the other
+    struct Group
+    {
+        uint32_t constraint;
+        int m;
+        std::vector<int> ks;
+    };
+
+    // Compositions [first, last) of a group
+    struct Task
+    {
+        uint32_t group;
+        size_t first, last;
+
+        ConstraintReport report;
+    };
+
+    // Rows of the matrices, in a form suited to rank computations
+    class RankEngine
+    {
+    public:
+        RankEngine(const std::vector<GFMatrix>& matrices, int q) :
+            q(q), size(matrices.empty() ? 0 : matrices[0].size()), words((size + 63) / 64)
+        {
+            if (q == 2)
+            {
+                bits.assign(matrices.size() * size * words, 0);
+                for (size_t d = 0; d < matrices.size(); d++)
+                    for (int i = 0; i < size; i++)
+                        for (int j = 0; j < size; j++)
+                            if (matrices[d][i][j]) bits[(d * size + i) * words + j / 64] |= uint64_t(1) << (j % 64);
+                return;
+            }
+
+            values.resize(matrices.size() * size * size);
+            for (size_t d = 0; d < matrices.size(); d++)
+                for (int i = 0; i < size; i++)
+                    for (int j = 0; j < size; j++)
+                        values[(d * size + i) * size + j] = matrices[d][i][j];
+        }
+
+        struct Workspace
+        {
+            std::vector<uint64_t> bits;
+            std::vector<GFElement> values;
+            std::vector<int> pivot;
+        };
+
+        // Whether the first m columns of the k[i] first rows of each matrix dims[i] are independent
+        template<class Field>
+        bool NonSingular(int m, const std::vector<int>& dims, const int* k, Workspace& ws, const Field& gf) const
+        {
+            return (q == 2) ? NonSingularBits(m, dims, k, ws) : NonSingularValues(m, dims, k, ws, gf);
+        }
+    private:
+        bool NonSingularBits(int m, const std::vector<int>& dims, const int* k, Workspace& ws) const
+        {
+            const int used = (m + 63) / 64;
+            const uint64_t lastMask = (m % 64 == 0) ? ~uint64_t(0) : ((uint64_t(1) << (m % 64)) - 1);
+
+            ws.bits.resize(size_t(m) * used);
+            ws.pivot.assign(m, -1);
+
+            int row = 0;
+            for (size_t i = 0; i < dims.size(); i++)
+            {
+                for (int r = 0; r < k[i]; r++, row++)
+                {
+                    uint64_t* v = ws.bits.data() + size_t(row) * used;
+                    const uint64_t* src = bits.data() + (size_t(dims[i]) * size + r) * words;
+                    std::copy(src, src + used, v);
+                    v[used - 1] &= lastMask;
+
+                    // Lowest non zero column only moves up when reduced by a pivot row
+                    while (true)
+                    {
+                        int w = 0;
+                        while (w < used && v[w] == 0) w++;
+                        if (w == used) return false;
+
+                        const int col = w * 64 + GF::CountTrailingZeros(v[w]);
+                        if (ws.pivot[col] < 0)
+                        {
+                            ws.pivot[col] = row;
+                            break;
+                        }
+                        const uint64_t* p = ws.bits.data() + size_t(ws.pivot[col]) * used;
+                        for (int x = w; x < used; x++) v[x] ^= p[x];
+                    }
+                }
+            }
+            return true;
+        }
+
+        template<class Field>
+        bool NonSingularValues(int m, const std::vector<int>& dims, const int* k, Workspace& ws, const Field& gf) const
+        {
+            ws.values.resize(size_t(m) * m);
+            ws.pivot.assign(m, -1);
+
+            int row = 0;
+            for (size_t i = 0; i < dims.size(); i++)
+            {
+                for (int r = 0; r < k[i]; r++, row++)
+                {
+                    GFElement* v = ws.values.data() + size_t(row) * m;
+                    const GFElement* src = values.data() + (size_t(dims[i]) * size + r) * size;
+                    std::copy(src, src + m, v);
+
+                    int col = 0;
+                    while (true)
+                    {
+                        while (col < m && v[col] == 0) col++;
+                        if (col == m) return false;
+
+                        if (ws.pivot[col] < 0)
+                        {
+                            // Pivot rows start with 1
+                            const int scale = gf.inv[v[col]];
+                            for (int x = col; x < m; x++) v[x] = GFElement(gf.times(scale, v[x]));
+                            ws.pivot[col] = row;
+                            break;
+                        }
+
+                        const GFElement* p = ws.values.data() + size_t(ws.pivot[col]) * m;
+                        const int factor = gf.neg[v[col]];
+                        for (int x = col; x < m; x++) v[x] = GFElement(gf.plus(v[x], gf.times(factor, p[x])));
+                    }
+                }
+            }
+            return true;
+        }
+
+        int q;
+        int size;
+        int words;
+
+        std::vector<uint64_t> bits;
+        std::vector<GFElement> values;
+    };
+}
+
+std::vector<ConstraintReport> CheckMatrices(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int threads)
+{
+    const Galois::Field gf(program.p);
+    const RankEngine engine(matrices, gf.q);
+    const int size = matrices.empty() ? 0 : matrices[0].size();
+
+    const uint32_t nbThreads = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // Compositions are listed once, then split in up to nbThreads ranges
+    std::vector<Group> groups;
+    std::vector<Task> tasks;
+    for (uint32_t c = 0; c < program.constraints.size(); c++)
+    {
+        const size_t s = program.constraints[c]->GetDims().size();
+        for (int m = 1; m <= size; m++)
+        {
+            if (!program.constraints[c]->IsActive(m)) continue;
+
+            Group group{c, m, {}};
+            program.constraints[c]->ForEachComposition(m, [&](const std::vector<int>& k) {
+                group.ks.insert(group.ks.end(), k.begin(), k.end());
+            });
+
+            const size_t count = group.ks.size() / s;
+            const size_t chunk = (count + nbThreads - 1) / nbThreads;
+            for (size_t first = 0; first < count; first += chunk)
+                tasks.push_back(Task{uint32_t(groups.size()), first, std::min(count, first + chunk), ConstraintReport()});
+            groups.push_back(std::move(group));
+        }
+    }
+
+    std::atomic<uint32_t> next(0);
+    auto work = [&]() {
+        GF::WithField(gf, [&](const auto& field) {
+            RankEngine::Workspace ws;
+            uint32_t t;
+            while ((t = next++) < tasks.size())
+            {
+                Task& task = tasks[t];
+                const Group& group = groups[task.group];
+                const auto start = std::chrono::steady_clock::now();
+
+                const auto& dims = program.constraints[group.constraint]->GetDims();
+                for (size_t i = task.first; i < task.last; i++)
+                {
+                    task.report.checked++;
+                    if (!engine.NonSingular(group.m, dims, group.ks.data() + i * dims.size(), ws, field))
+                    {
+                        task.report.violations++;
+                        task.report.firstM = group.m;
+                    }
+                }
+
+                task.report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        });
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t i = 1; i < nbThreads; i++) pool.emplace_back(work);
+    work();
+    for (auto& thread : pool) thread.join();
+
+    std::vector<ConstraintReport> reports(program.constraints.size());
+    for (const auto& task : tasks)
+    {
+        ConstraintReport& report = reports[groups[task.group].constraint];
+        report.checked    += task.report.checked;
+        report.violations += task.report.violations;
+        report.seconds    += task.report.seconds;
+        if (task.report.firstM && (report.firstM == 0 || task.report.firstM < report.firstM))
+            report.firstM = task.report.firstM;
+    }
+    return reports;
+}
+
+bool PrintCheckReport(const MatbuilderProgram& program, const std::vector<ConstraintReport>& reports, std::ostream& out)
+{
+    bool valid = true;
+    out << "constraint\tdims\tchecked\tviolations\tfirst m\ttime (ms)" << '\n';
+    for (uint32_t c = 0; c < reports.size(); c++)
+    {
+        const auto& constraint = *program.constraints[c];
+        const auto& report = reports[c];
+
+        out << c << (constraint.GetModifier().weak ? " (weak)" : "") << '\t';
+        for (uint32_t i = 0; i < constraint.GetDims().size(); i++)
+            out << (i ? "," : "") << constraint.GetDims()[i];
+        out << '\t' << report.checked << '\t' << report.violations << '\t' << report.firstM << '\t'
+            << report.seconds * 1000. << '\n';
+
+        if (report.violations && !constraint.GetModifier().weak) valid = false;
+    }
+    out << (valid ? "All hard constraints are satisfied" : "Some hard constraints are not satisfied") << std::endl;
+    return valid;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "utils/GFMatrix.hpp"
+#include "Parser.hpp"
+
+// Checks every composition of every constraint of a profile on complete matrices,
+// for each m up to their size. Compositions are listed once, and split across threads
+// by constraint, m and range; ranks are computed on bit packed rows in base 2, and with
+// the fields of GFArithmetic.hpp otherwise.
+struct ConstraintReport
+{
+    uint64_t checked = 0;
+    uint64_t violations = 0;
+    // First m with a singular composition, 0 if none
+    int firstM = 0;
+    // Time spent on the constraint, summed over threads
+    double seconds = 0;
+};
+
+// threads = 0 uses every available core
+std::vector<ConstraintReport> CheckMatrices(const MatbuilderProgram& program, const std::vector<GFMatrix>& matrices, int threads = 0);
+
+// Writes one line per constraint. Returns false if a hard constraint is violated.
+bool PrintCheckReport(const MatbuilderProgram& program, const std::vector<ConstraintReport>& reports, std::ostream& out);
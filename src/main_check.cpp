@@ -0,0 +1,55 @@
+#include <chrono>
+
+#include "utils/GFMatrix.hpp"
+#include "utils/CLI11.hpp"
+
+#include "Matbuilder/Solver.hpp"
+#include "Matbuilder/Parser.hpp"
+#include "Matbuilder/Constraints.hpp"
+#include "Matbuilder/Verifier.hpp"
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Matbuilder property checker"};
+
+    std::string filename;
+    app.add_option("-i", filename, "Input file name")->required();
+    std::string matFile;
+    app.add_option("-m", matFile, "Matrices file name")->required();
+    int nbThreads = 0;
+    app.add_option("--threads", nbThreads, "Number of threads to use (def: all avalaible)");
+
+    CLI11_PARSE(app, argc, argv);
+
+    Parser parser;
+    parser.RegisterConstraint("net",        Constraint::Create<ZeroNetConstraint>);
+    parser.RegisterConstraint("stratified", Constraint::Create<StratifiedConstraint>);
+    parser.RegisterConstraint("propA",      Constraint::Create<PropAConstraint>);
+    parser.RegisterConstraint("propA'",     Constraint::Create<PropAprimeConstraint>);
+
+    auto program = parser.Parse(filename);
+    if (!program.is_valid)
+    {
+        std::cout << "Invalid program" << std::endl;
+        return 1;
+    }
+
+    std::ifstream matF(matFile);
+    if (!matF.is_open())
+    {
+        std::cerr << "No such file or directory : " << matFile << std::endl;
+        return 1;
+    }
+
+    std::vector<GFMatrix> matrices;
+    if (!ReadMatrices(matF, matrices) || !Solver::ValidateMatrices(program, matrices))
+        return 1;
+
+    auto start = std::chrono::steady_clock::now();
+    const auto reports = CheckMatrices(program, matrices, nbThreads);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    const bool valid = PrintCheckReport(program, reports, std::cout);
+    std::cout << "Checked m = 1 to " << matrices[0].size() << " in " << elapsed.count() << " milliseconds." << std::endl;
+    return valid ? 0 : 2;
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cmath>
+
+#include "utils/GFMatrix.hpp"
+#include "utils/Points.hpp"
+#include "utils/Scrambling.hpp"
+#include "utils/Discrepancy.hpp"
+#include "utils/CLI11.hpp"
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Matbuilder discrepancy"};
+
+    std::string matFile;
+    app.add_option("-m", matFile, "Matrices file name")->required();
+    int b = 2;
+    app.add_option("-b", b, "Matrices basis (def: 2)");
+    uint64_t count = 0;
+    app.add_option("-n", count, "Number of points (def: b^m)");
+    int nbThreads = 0;
+    app.add_option("--threads", nbThreads, "Number of threads to use (def: all avalaible)");
+    std::string scramble;
+    app.add_option("--scramble", scramble, "Randomization: none, shift or owen")->default_val("none");
+    int scrambleSeed = 133742;
+    app.add_option("--scrambleSeed", scrambleSeed, "Randomization seed");
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::ifstream matF(matFile);
+    if (!matF.is_open())
+    {
+        std::cerr << "No such file or directory : " << matFile << std::endl;
+        return 1;
+    }
+
+    std::vector<GFMatrix> matrices;
+    if (!ReadMatrices(matF, matrices) || !ValidateMatrices(matrices, b))
+        return 1;
+    if (matrices[0].size() > PointGenerator::MaxSize)
+        std::cerr << "Warning: only the first " << PointGenerator::MaxSize << " columns of the matrices are used" << std::endl;
+
+    Scrambler::Type type = Scrambler::Type::None;
+    if      (scramble == "shift") type = Scrambler::Type::DigitalShift;
+    else if (scramble == "owen")  type = Scrambler::Type::Owen;
+    else if (scramble != "none")
+    {
+        std::cerr << "Unknown randomization " << scramble << std::endl;
+        return 1;
+    }
+
+    const PointGenerator generator(matrices, b);
+    if (count == 0) count = generator.Count();
+    if (count > generator.Count())
+    {
+        std::cerr << "Error: the matrices only define " << generator.Count() << " points" << std::endl;
+        return 1;
+    }
+    const int s = generator.Dimensions();
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<double> points(count * s);
+    generator.Generate(0, count, points.data(), nbThreads);
+    Scrambler(b, s, type, scrambleSeed).Apply(points.data(), count, nbThreads);
+
+    const auto l2 = ComputeL2Discrepancies(points, s, nbThreads);
+    std::cout << "L2-star discrepancy      " << std::sqrt(std::max(0., l2.star)) << '\n';
+    std::cout << "Symmetric discrepancy    " << std::sqrt(std::max(0., l2.symmetric)) << '\n';
+    std::cout << "Wrap-around discrepancy  " << std::sqrt(std::max(0., l2.wrapAround)) << '\n';
+
+    // Only defined for the whole net, and does not depend on the randomization
+    if (count == generator.Count())
+    {
+        const double shifted = ShiftAveragedL2Star(matrices, b, nbThreads);
+        std::cout << "Shift averaged L2-star   " << std::sqrt(std::max(0., shifted)) << '\n';
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << count << " points in " << elapsed.count() << " milliseconds." << std::endl;
+    return 0;
+}
@@ -40,7 +40,8 @@ int main(int argc, char** argv)
     
     if (program.is_valid)
     {
-        sParams.rng.discard(program.s * (program.m * (program.m + 1)) / 2);
+        RemoveImpliedConstraints(program, std::cout);
+
         std::vector<GFMatrix> matrices;
         {
             std::ifstream matF(matFile);
@@ -51,59 +52,16 @@ int main(int argc, char** argv)
                 return 1;
             }
 
-            while (matF.good())
-                matrices.push_back(GFMatrix::From(matF));
+            if (!ReadMatrices(matF, matrices))
+                return 1;
             
             if (matrices.size() == 0) // No matrix read, assume to generate m=0
-            {
                 matrices = std::vector<GFMatrix>(program.s, GFMatrix(0));
-            }
-            else
-            {
-                if (matrices.size() != program.s)
-                {
-                    std::cerr << "Matrix file does not have enough dimensions" << std::endl;
-                    return 0;
-                }
-            
-                int maxMat = -32765;
-                int minMat =  32765;
-                bool sameSize = true;
-                for (unsigned int i = 0; i < matrices.size(); i++)
-                {
-                    sameSize = sameSize && (matrices[i].size() == matrices[0].size());
-                    for (unsigned int j = 0; j < matrices[i].size(); i++)
-                    {
-                        for (unsigned int k = 0; k < matrices[i].size(); k++)
-                        {
-                            maxMat = std::max(maxMat, matrices[i][j][k]);
-                            minMat = std::min(minMat, matrices[i][j][k]);
-                        }
-                    }
-                }
-
-                if (minMat < 0)
-                {
-                    std::cerr << "Error: generated matrix has negative numbers" << std::endl;
-                    return 1;
-                }
-
-                if (maxMat >= program.p) 
-                {
-                    std::cerr << "Error: generated matrix has numbers greater than base" << std::endl;
-                    return 1;
-                }
-
-                if (!sameSize)
-                {
-                    std::cerr << "Error: all matrices must have the same size !" << std::endl;
-                    return 1;
-                }
-            }
+            else if (!Solver::ValidateMatrices(program, matrices))
+                return 1;
         }
 
-        sParams.rng.discard(matrices[0].size() * matrices.size());
-
+        Solver::AdvanceRNG(sParams.rng, program, matrices[0].size());
 
         Solver solver(sParams, nullptr);
         auto ilp = solver.GetILP(program, matrices, matrices[0].size() + 1);
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <iomanip>
+
+#include "utils/GFMatrix.hpp"
+#include "utils/Points.hpp"
+#include "utils/Scrambling.hpp"
+#include "utils/CLI11.hpp"
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Matbuilder point generator"};
+
+    std::string matFile;
+    app.add_option("-m", matFile, "Matrices file name")->required();
+    std::string outfile;
+    app.add_option("-o", outfile, "Output file name");
+    int b = 2;
+    app.add_option("-b", b, "Matrices basis (def: 2)");
+    uint64_t count = 0;
+    app.add_option("-n", count, "Number of points (def: b^m)");
+    uint64_t first = 0;
+    app.add_option("--first", first, "Index of the first point (def: 0)");
+    int nbThreads = 0;
+    app.add_option("--threads", nbThreads, "Number of threads to use (def: all avalaible)");
+    std::string scramble;
+    app.add_option("--scramble", scramble, "Randomization: none, shift or owen")->default_val("none");
+    int scrambleSeed = 133742;
+    app.add_option("--scrambleSeed", scrambleSeed, "Randomization seed");
+    bool binary = false;
+    app.add_flag("--binary", binary, "Writes points as raw doubles instead of text");
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::ifstream matF(matFile);
+    if (!matF.is_open())
+    {
+        std::cerr << "No such file or directory : " << matFile << std::endl;
+        return 1;
+    }
+
+    std::vector<GFMatrix> matrices;
+    if (!ReadMatrices(matF, matrices) || !ValidateMatrices(matrices, b))
+        return 1;
+    if (matrices[0].size() > PointGenerator::MaxSize)
+        std::cerr << "Warning: only the first " << PointGenerator::MaxSize << " columns of the matrices are used" << std::endl;
+
+    Scrambler::Type type = Scrambler::Type::None;
+    if      (scramble == "shift") type = Scrambler::Type::DigitalShift;
+    else if (scramble == "owen")  type = Scrambler::Type::Owen;
+    else if (scramble != "none")
+    {
+        std::cerr << "Unknown randomization " << scramble << std::endl;
+        return 1;
+    }
+
+    const PointGenerator generator(matrices, b);
+    const Scrambler scrambler(b, generator.Dimensions(), type, scrambleSeed);
+    if (count == 0) count = generator.Count();
+
+    std::ofstream fileOut(outfile, binary ? std::ios::binary : std::ios::out);
+    std::ostream* out = &std::cout;
+    if (fileOut.is_open())
+        out = &fileOut;
+    *out << std::setprecision(17);
+
+    // Points are generated by blocks, so that memory does not grow with their number
+    const uint64_t blockSize = uint64_t(1) << 20;
+    const int s = generator.Dimensions();
+    std::vector<double> block(std::min(count, blockSize) * s);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t done = 0; done < count; done += blockSize)
+    {
+        const uint64_t size = std::min(blockSize, count - done);
+        generator.Generate(first + done, size, block.data(), nbThreads);
+        scrambler.Apply(block.data(), size, nbThreads);
+
+        if (binary)
+        {
+            out->write(reinterpret_cast<const char*>(block.data()), size * s * sizeof(double));
+            continue;
+        }
+        for (uint64_t n = 0; n < size; n++)
+        {
+            for (int k = 0; k < s; k++)
+                *out << (k ? " " : "") << block[n * s + k];
+            *out << '\n';
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cerr << count << " points in " << elapsed.count() << " milliseconds." << std::endl;
+    return 0;
+}
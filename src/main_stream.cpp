@@ -0,0 +1,36 @@
+#include "utils/GFMatrix.hpp"
+#include "utils/CLI11.hpp"
+
+#include "Matbuilder/StreamLog.hpp"
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Matbuilder stream converter"};
+
+    std::string filename;
+    app.add_option("-i", filename, "Stream file name")->required();
+    std::string outfile;
+    app.add_option("-o", outfile, "Output file name");
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<GFMatrix> matrices;
+    if (!StreamLog::Read(filename, matrices))
+    {
+        std::cerr << "Can not read stream file " << filename << std::endl;
+        return 1;
+    }
+
+    std::ofstream fileOut(outfile);
+    std::ostream* out = &std::cout;
+    if (fileOut.is_open())
+        out = &fileOut;
+
+    for (const auto& mat : matrices)
+    {
+        mat.To(*out);
+        *out << '\n';
+    }
+
+    return 0;
+}
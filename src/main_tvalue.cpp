@@ -0,0 +1,75 @@
+#include <chrono>
+#include <algorithm>
+
+#include "utils/GFMatrix.hpp"
+#include "utils/TValue.hpp"
+#include "utils/CLI11.hpp"
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Matbuilder t-value computation"};
+
+    std::string matFile;
+    app.add_option("-m", matFile, "Matrices file name")->required();
+    std::string outfile;
+    app.add_option("-o", outfile, "Output file name");
+    int b = 2;
+    app.add_option("-b", b, "Matrices basis (def: 2)");
+    int order = 2;
+    app.add_option("--order", order, "Largest projection size (def: 2)");
+    int nbThreads = 0;
+    app.add_option("--threads", nbThreads, "Number of threads to use (def: all avalaible)");
+
+    CLI11_PARSE(app, argc, argv);
+
+    if (order < 1)
+    {
+        std::cerr << "Error: --order must be at least 1" << std::endl;
+        return 1;
+    }
+
+    std::ifstream matF(matFile);
+    if (!matF.is_open())
+    {
+        std::cerr << "No such file or directory : " << matFile << std::endl;
+        return 1;
+    }
+
+    std::vector<GFMatrix> matrices;
+    if (!ReadMatrices(matF, matrices) || !ValidateMatrices(matrices, b))
+        return 1;
+
+    auto start = std::chrono::steady_clock::now();
+    const auto projections = ComputeTValues(matrices, b, order, nbThreads);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    std::ofstream fileOut(outfile);
+    std::ostream* out = &std::cout;
+    if (fileOut.is_open())
+        out = &fileOut;
+
+    // One line per projection: its dimensions, then t for m = 1 to size
+    const int size = matrices[0].size();
+    std::vector<std::vector<int>> worst(order, std::vector<int>(size, 0));
+    for (const auto& projection : projections)
+    {
+        for (size_t i = 0; i < projection.dims.size(); i++)
+            *out << (i ? "," : "") << projection.dims[i];
+        for (int m = 0; m < size; m++)
+        {
+            *out << '\t' << projection.t[m];
+            worst[projection.dims.size() - 1][m] = std::max(worst[projection.dims.size() - 1][m], projection.t[m]);
+        }
+        *out << '\n';
+    }
+
+    std::cout << "Largest t by order:" << '\n';
+    for (int o = 0; o < order && o < int(matrices.size()); o++)
+    {
+        std::cout << o + 1;
+        for (int m = 0; m < size; m++) std::cout << '\t' << worst[o][m];
+        std::cout << '\n';
+    }
+    std::cout << projections.size() << " projections in " << elapsed.count() << " milliseconds." << std::endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include "Discrepancy.hpp"
+#include "Points.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+namespace
+{
+    const int BlockSize = 64;
+
+    // Pair sums of the closed forms, for the pairs of two blocks
+    struct PairSums
+    {
+        long double star = 0, symmetric = 0, wrapAround = 0;
+    };
+
+    void BlockPairs(const double* a, int na, const double* b, int nb, int s, bool same, PairSums& sums)
+    {
+        for (int i = 0; i < na; i++)
+        {
+            const double* x = a + i * s;
+            for (int j = same ? i : 0; j < nb; j++)
+            {
+                const double* y = b + j * s;
+                double star = 1., symmetric = 1., wrapAround = 1.;
+                for (int k = 0; k < s; k++)
+                {
+                    const double d = std::abs(x[k] - y[k]);
+                    star       *= 1. - std::max(x[k], y[k]);
+                    symmetric  *= 1. - d;
+                    wrapAround *= 1.5 - d * (1. - d);
+                }
+
+                // Pairs (i, j) and (j, i)
+                const double weight = (same && i == j) ? 1. : 2.;
+                sums.star       += weight * star;
+                sums.symmetric  += weight * symmetric;
+                sums.wrapAround += weight * wrapAround;
+            }
+        }
+    }
+
+    uint32_t ThreadCount(int threads)
+    {
+        return (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+L2Discrepancies ComputeL2Discrepancies(const std::vector<double>& points, int s, int threads)
+{
+    const uint64_t n = points.size() / s;
+    const uint64_t blocks = (n + BlockSize - 1) / BlockSize;
+
+    // Sums over single points
+    long double star = 0, symmetric = 0;
+    for (uint64_t i = 0; i < n; i++)
+    {
+        double starTerm = 1., symmetricTerm = 1.;
+        for (int k = 0; k < s; k++)
+        {
+            const double x = points[i * s + k];
+            starTerm      *= (1. - x * x) / 2.;
+            symmetricTerm *= 1. + 2. * x - 2. * x * x;
+        }
+        star      += starTerm;
+        symmetric += symmetricTerm;
+    }
+
+    // Row blocks are shared between threads, each against the blocks after it
+    std::vector<PairSums> rows(blocks);
+    std::atomic<uint64_t> next(0);
+    auto work = [&]() {
+        uint64_t r;
+        while ((r = next++) < blocks)
+        {
+            const uint64_t first = r * BlockSize;
+            const int size = int(std::min<uint64_t>(BlockSize, n - first));
+            for (uint64_t c = r; c < blocks; c++)
+            {
+                const uint64_t other = c * BlockSize;
+                const int otherSize = int(std::min<uint64_t>(BlockSize, n - other));
+                BlockPairs(points.data() + first * s, size, points.data() + other * s, otherSize, s, c == r, rows[r]);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t i = 1; i < ThreadCount(threads); i++) pool.emplace_back(work);
+    work();
+    for (auto& thread : pool) thread.join();
+
+    // Rows are added in order, so that the result does not depend on the threads
+    PairSums pairs;
+    for (const auto& row : rows)
+    {
+        pairs.star       += row.star;
+        pairs.symmetric  += row.symmetric;
+        pairs.wrapAround += row.wrapAround;
+    }
+
+    const long double N = n;
+    L2Discrepancies result;
+    result.star       = double(std::pow(1.L / 3.L, s) - 2.L / N * star + pairs.star / (N * N));
+    result.symmetric  = double(std::pow(4.L / 3.L, s) - 2.L / N * symmetric + std::pow(2.L, s) * pairs.symmetric / (N * N));
+    result.wrapAround = double(-std::pow(4.L / 3.L, s) + pairs.wrapAround / (N * N));
+    return result;
+}
+
+double ShiftAveragedL2Star(const std::vector<GFMatrix>& matrices, int q, int threads)
+{
+    const Galois::Field gf(q);
+    const int s = matrices.size();
+    const int m = matrices.empty() ? 0 : std::min(matrices[0].size(), PointGenerator::MaxSize);
+
+    // kernel[r * q + z], first non zero digit z at position r + 1
+    std::vector<double> kernel(size_t(m) * q, 0.5);
+    double weight = 1.;
+    for (int r = 0; r < m; r++)
+    {
+        weight /= q;
+        for (int z = 1; z < q; z++)
+        {
+            double mean = 0;
+            for (int a = 0; a < q; a++) mean += std::abs(gf.plus(a, z) - a);
+            kernel[r * q + z] = 0.5 - weight * mean / q / 2.;
+        }
+    }
+
+    uint64_t n = 1;
+    for (int j = 0; j < m; j++) n *= q;
+
+    const uint32_t nbThreads = ThreadCount(threads);
+    const uint64_t chunk = (n + nbThreads - 1) / nbThreads;
+    std::vector<long double> sums(nbThreads, 0);
+
+    auto work = [&](uint32_t t) {
+        const uint64_t first = std::min(n, t * chunk);
+        const uint64_t last  = std::min(n, first + chunk);
+        if (first == last) return;
+
+        // Digits y[k * m + r] of every dimension, updated as the index is incremented
+        std::vector<int> index(m, 0);
+        std::vector<int> y(size_t(s) * m, 0);
+        auto addColumn = [&](int j, int times) {
+            for (int k = 0; k < s; k++)
+                for (int r = 0; r < m; r++)
+                    y[k * m + r] = gf.plus(y[k * m + r], gf.times(times, matrices[k][r][j]));
+        };
+
+        uint64_t rest = first;
+        for (int j = 0; j < m; j++, rest /= q)
+        {
+            index[j] = rest % q;
+            if (index[j]) addColumn(j, index[j]);
+        }
+
+        for (uint64_t i = first; i < last; i++)
+        {
+            long double product = 1;
+            for (int k = 0; k < s; k++)
+            {
+                const int* digits = y.data() + k * m;
+                int r = 0;
+                while (r < m && digits[r] == 0) r++;
+                product *= (r == m) ? 0.5 : kernel[r * q + digits[r]];
+            }
+            sums[t] += product;
+
+            // Digit j goes from a to a + 1 (mod q): its column is added (a + 1) - a times
+            for (int j = 0; j < m; j++)
+            {
+                const int next = (index[j] + 1) % q;
+                addColumn(j, gf.plus(next, gf.neg[index[j]]));
+                index[j] = next;
+                if (next != 0) break;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t t = 1; t < nbThreads; t++) pool.emplace_back(work, t);
+    work(0);
+    for (auto& thread : pool) thread.join();
+
+    long double sum = 0;
+    for (const auto& partial : sums) sum += partial;
+    return double(-std::pow(1.L / 3.L, s) + sum / n);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GFMatrix.hpp"
+
+// Squared L2 discrepancies of points in [0, 1)^s, stored one after the other
+//
+// The closed forms (Warnock for the star discrepancy, Hickernell for the symmetric and
+// wrap-around ones) have a sum over all pairs of points. It is computed by blocks of
+// points, shared between threads (0 uses every available core), in O(N^2 s).
+struct L2Discrepancies
+{
+    double star = 0;
+    double symmetric = 0;
+    double wrapAround = 0;
+};
+
+L2Discrepancies ComputeL2Discrepancies(const std::vector<double>& points, int s, int threads = 0);
+
+// Mean squared L2-star discrepancy of the digital net of the matrices (all q^m points)
+// over random digital shifts, in O(N s m).
+//
+// Points of a digital net are a group for digit addition, so the pair sum reduces to
+// E = -1/3^s + 1/N sum_n prod_k K(x_nk), where K(0) = 1/2 and otherwise, with i the
+// position of the first non zero digit, of value z: K(x) = 1/2 - q^-i E|(a + z) - a| / 2
+// over the digits a (2 z (q - z) / q when q is prime).
+double ShiftAveragedL2Star(const std::vector<GFMatrix>& matrices, int q, int threads = 0);
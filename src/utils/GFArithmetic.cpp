@@ -0,0 +1,91 @@
+#include "GFArithmetic.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace GF
+{
+    MontgomeryField::MontgomeryField(const Galois::Field& gf) :
+        q(gf.q), neg(gf.q), inv(gf.q)
+    {
+        for (int a = 0; a < q; a++)
+        {
+            neg[a] = gf.neg[a];
+            inv[a] = gf.inv[a];
+        }
+
+        // Newton iterations double the correct low bits of q^-1 mod 2^32
+        uint32_t x = uint32_t(q);
+        for (int i = 0; i < 5; i++) x *= 2u - uint32_t(q) * x;
+        qInv = 0u - x;
+
+        const uint64_t r = (uint64_t(1) << 32) % uint64_t(q);
+        r2 = r * r % uint64_t(q);
+    }
+
+    LogField::LogField(const Galois::Field& gf) :
+        q(gf.q), neg(gf.q), inv(gf.q), log(gf.q, 0), exp(2 * (gf.q - 1))
+    {
+        for (int a = 0; a < q; a++)
+        {
+            neg[a] = gf.neg[a];
+            inv[a] = gf.inv[a];
+        }
+
+        // First element of order q - 1
+        for (int g = 2; g < q; g++)
+        {
+            int x = 1, order = 0;
+            do
+            {
+                exp[order++] = x;
+                x = gf.times(x, g);
+            } while (x != 1);
+            if (order == q - 1) break;
+        }
+        for (int k = 0; k < q - 1; k++)
+        {
+            exp[k + q - 1] = exp[k];
+            log[exp[k]] = k;
+        }
+
+        // Addition is a group morphism: it is XOR when it is XOR with every power of 2
+        xorPlus = (q & (q - 1)) == 0;
+        for (int a = 0; a < q && xorPlus; a++)
+            for (int bit = 1; bit < q && xorPlus; bit <<= 1)
+                xorPlus = gf.plus(a, bit) == (a ^ bit);
+
+        zech.resize(2 * (q - 1));
+        for (int k = 0; k < q - 1; k++)
+        {
+            const int sum = gf.plus(1, exp[k]);
+            zech[k] = zech[k + q - 1] = (sum == 0) ? -1 : log[sum];
+        }
+    }
+
+    namespace
+    {
+        template<class Field>
+        const Field& GetCached(const Galois::Field& gf)
+        {
+            static std::mutex mutex;
+            static std::map<int, std::unique_ptr<Field>> fields;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& field = fields[gf.q];
+            if (!field) field = std::make_unique<Field>(gf);
+            return *field;
+        }
+    }
+
+    const MontgomeryField& GetMontgomeryField(const Galois::Field& gf)
+    {
+        return GetCached<MontgomeryField>(gf);
+    }
+
+    const LogField& GetLogField(const Galois::Field& gf)
+    {
+        return GetCached<LogField>(gf);
+    }
+}
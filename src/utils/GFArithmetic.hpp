@@ -0,0 +1,233 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <galois++/field.h>
+
+// Field arithmetic known at compile time for the common bases, with the same interface as
+// Galois::Field (q, plus, times, neg[], inv[]), so that hot loops written as templates on
+// the field are instantiated for the concrete base. Other bases use Galois::Field itself.
+//
+// Primes use modular arithmetic on constants. Prime powers use the polynomial basis
+// (element a is the polynomial of its base p digits) modulo a fixed irreducible polynomial,
+// and are only used when galois++ encodes the field the same way.
+//
+// Above LargeBase, the q^2 tables of galois++ no longer fit in cache: large primes use
+// Montgomery multiplication and large prime powers logarithm tables, both in O(q) memory.
+namespace GF
+{
+    // Index of the lowest set bit of a non zero word
+    inline int CountTrailingZeros(uint64_t word)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(word);
+#else
+        int count = 0;
+        while (!(word & 1)) { word >>= 1; count++; }
+        return count;
+#endif
+    }
+
+    // Product of polynomials over GF(2) (bit i is the coefficient of x^i), reduced by poly
+    constexpr int CarrylessTimes(int a, int b, int poly, int degree)
+    {
+        int result = 0;
+        for (int i = 0; i < degree; i++)
+            if ((b >> i) & 1) result ^= a << i;
+        for (int i = 2 * degree - 2; i >= degree; i--)
+            if ((result >> i) & 1) result ^= poly << (i - degree);
+        return result;
+    }
+
+    constexpr bool IsPrime(int q)
+    {
+        for (int d = 2; d * d <= q; d++)
+            if (q % d == 0) return false;
+        return q > 1;
+    }
+
+    // Irreducible polynomial used for GF(2^n), 0 when the field has no static version
+    constexpr int Polynomial(int q)
+    {
+        return q == 4 ? 0b111 : (q == 8 ? 0b1011 : 0);
+    }
+
+    constexpr int Degree(int q)
+    {
+        int degree = 0;
+        while ((1 << degree) < q) degree++;
+        return degree;
+    }
+
+    template<int Q>
+    struct StaticField
+    {
+        static_assert(IsPrime(Q) || Polynomial(Q) != 0, "No static field for this base");
+
+        static constexpr int q = Q;
+        static constexpr bool prime = IsPrime(Q);
+
+        static constexpr int plus(int a, int b)
+        {
+            if constexpr (Q == 2 || !prime) return a ^ b;
+            else
+            {
+                const int sum = a + b;
+                return sum >= Q ? sum - Q : sum;
+            }
+        }
+
+        static constexpr int times(int a, int b)
+        {
+            if constexpr (Q == 2) return a & b;
+            else if constexpr (prime) return (a * b) % Q;
+            else return multiplication[a * Q + b];
+        }
+
+        static constexpr std::array<int, Q * Q> MakeMultiplication()
+        {
+            std::array<int, Q * Q> table{};
+            for (int a = 0; a < Q; a++)
+                for (int b = 0; b < Q; b++)
+                    table[a * Q + b] = prime ? (a * b) % Q : CarrylessTimes(a, b, Polynomial(Q), Degree(Q));
+            return table;
+        }
+
+        static constexpr std::array<int, Q> MakeNeg()
+        {
+            std::array<int, Q> table{};
+            for (int a = 0; a < Q; a++) table[a] = (prime && a) ? Q - a : a;
+            return table;
+        }
+
+        static constexpr std::array<int, Q> MakeInv()
+        {
+            const auto mul = MakeMultiplication();
+            std::array<int, Q> table{};
+            for (int a = 1; a < Q; a++)
+                for (int b = 1; b < Q; b++)
+                    if (mul[a * Q + b] == 1) table[a] = b;
+            return table;
+        }
+
+        static constexpr std::array<int, Q * Q> multiplication = MakeMultiplication();
+        static constexpr std::array<int, Q> neg = MakeNeg();
+        static constexpr std::array<int, Q> inv = MakeInv();
+
+        // Whether gf encodes elements as this field does
+        static bool Matches(const Galois::Field& gf)
+        {
+            for (int a = 0; a < Q; a++)
+                for (int b = 0; b < Q; b++)
+                    if (gf.plus(a, b) != plus(a, b) || gf.times(a, b) != times(a, b)) return false;
+            return true;
+        }
+    };
+
+    const int LargeBase = 256;
+
+    // Prime field, products are reduced without division (Montgomery, R = 2^32)
+    struct MontgomeryField
+    {
+        explicit MontgomeryField(const Galois::Field& gf);
+
+        int q;
+        std::vector<int> neg, inv;
+
+        int plus(int a, int b) const
+        {
+            const int sum = a + b;
+            return sum >= q ? sum - q : sum;
+        }
+
+        // a b R^-1 R^2 R^-1 = a b, each reduction is below 2 q
+        int times(int a, int b) const
+        {
+            const uint64_t product = Reduce(uint64_t(a) * uint64_t(b)) * r2;
+            const uint32_t result = uint32_t(Reduce(product));
+            return int(result >= uint32_t(q) ? result - q : result);
+        }
+
+    private:
+        // t R^-1 mod q, up to q, for t < q R
+        uint64_t Reduce(uint64_t t) const
+        {
+            const uint32_t m = uint32_t(t) * qInv;
+            return (t + uint64_t(m) * uint32_t(q)) >> 32;
+        }
+
+        uint32_t qInv = 0; // -q^-1 mod R
+        uint64_t r2 = 0;   // R^2 mod q
+    };
+
+    // Prime power field through discrete logarithms of a generator g: products add
+    // logarithms, and sums use Zech logarithms (1 + g^k = g^zech[k]) unless addition is XOR.
+    // Tables are built from gf, so that elements are encoded as in galois++.
+    struct LogField
+    {
+        explicit LogField(const Galois::Field& gf);
+
+        int q;
+        std::vector<int> neg, inv;
+
+        int plus(int a, int b) const
+        {
+            if (xorPlus) return a ^ b;
+            if (a == 0) return b;
+            if (b == 0) return a;
+
+            const int z = zech[log[b] - log[a] + q - 1];
+            return z < 0 ? 0 : exp[log[a] + z];
+        }
+
+        int times(int a, int b) const
+        {
+            return (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+        }
+
+    private:
+        bool xorPlus = false;
+        std::vector<int> log;
+        std::vector<int> exp;  // 2 (q - 1) powers, so that sums of logarithms are not reduced
+        std::vector<int> zech; // Shifted by q - 1 and repeated, -1 when 1 + g^k = 0
+    };
+
+    // Fields of large bases, built once for each base and shared between threads
+    const MontgomeryField& GetMontgomeryField(const Galois::Field& gf);
+    const LogField& GetLogField(const Galois::Field& gf);
+
+    // Calls f with the fastest field of gf.q: static for small bases, O(q) tables for large
+    // ones, gf otherwise
+    template<class F>
+    decltype(auto) WithField(const Galois::Field& gf, F&& f)
+    {
+        switch (gf.q)
+        {
+        case 2: return f(StaticField<2>());
+        case 3: return f(StaticField<3>());
+        case 5: return f(StaticField<5>());
+        case 7: return f(StaticField<7>());
+        case 4:
+        {
+            static const bool matches = StaticField<4>::Matches(gf);
+            if (matches) return f(StaticField<4>());
+            break;
+        }
+        case 8:
+        {
+            static const bool matches = StaticField<8>::Matches(gf);
+            if (matches) return f(StaticField<8>());
+            break;
+        }
+        default:
+            if (gf.q > LargeBase)
+            {
+                if (IsPrime(gf.q)) return f(GetMontgomeryField(gf));
+                return f(GetLogField(gf));
+            }
+            break;
+        }
+        return f(gf);
+    }
+}
@@ -2,63 +2,11 @@
 
 #include <iostream>
 #include <sstream>
+#include <limits>
 
 int GFMatrix::determinant(const Galois::Field& gf, int override_m) const
 {
-    const int M = (override_m < 0) ?  m : std::min(m, override_m);
-
-    GFMatrix memory = *this;
-
-    int factorPermut = 1;
-    for (int i = 0; i < M; i++)
-    {
-        int swapi = i;
-        while (swapi < M && memory[swapi][i] == 0) swapi ++;
-
-        if (swapi >= M) return 0;
-        else if (swapi != i)
-        {
-            factorPermut *= -1;
-            for (int k = i; k < M; k++)
-            {
-                std::swap(memory[swapi][k], memory[i][k]);
-            }
-        }
-
-
-        for (int j = i + 1; j < M; j++)
-        {
-            if (memory[j][i] != 0)
-            {
-                int factor = gf.neg[
-                    gf.times(
-                        gf.inv[memory[i][i]], 
-                               memory[j][i]
-                    )
-                ];
-
-                for (int k = i; k < m; k++)
-                {
-                    memory[j][k] = gf.plus(
-                        memory[j][k], 
-                        gf.times(
-                            factor, 
-                            memory[i][k]
-                        )
-                    );
-                }
-            }
-        }
-    }
-
-    int res = 1;
-    for (int i = 0; i < M; i++)
-    {
-        res = gf.times(res, memory[i][i]);
-    }
-
-    if (factorPermut == 1) return res;
-    return gf.neg[res];
+    return GF::WithField(gf, [&](const auto& field) { return Determinant(field, override_m); });
 }
 
 void GFMatrix::Print() const
@@ -67,7 +15,7 @@ void GFMatrix::Print() const
     {
         for (unsigned int j = 0; j < m; j++)
         {
-            std::cout << at(i, j) << " ";
+            std::cout << int(at(i, j)) << " ";
         }
         std::cout << std::endl;
     }
@@ -98,8 +46,23 @@ GFMatrix GFMatrix::From(std::istream& iss)
 
     int m = firstLine.size();
 
+    // Coefficients are checked against the base later, only their storage range here
+    const auto outOfRange = [](const std::vector<int>& line) {
+        for (int value : line)
+        {
+            if (value < 0 || value > std::numeric_limits<GFElement>::max())
+            {
+                std::cerr << "Error: matrix coefficient " << value << " can not be stored" << std::endl;
+                return true;
+            }
+        }
+        return false;
+    };
+    // A bad matrix is still read to its last row, so that the next one starts in place
+    bool valid = !outOfRange(firstLine);
+
     GFMatrix rslt(m);
-    for (int i = 0; i < m; i++) rslt[0][i] = firstLine[i];
+    for (int i = 0; i < m && valid; i++) rslt[0][i] = firstLine[i];
     for (int i = 1; i < m; i++)
     {
         if (!iss.good()) { return GFMatrix(0); }
@@ -107,20 +70,92 @@ GFMatrix GFMatrix::From(std::istream& iss)
         std::getline(iss, tmpS);
         const std::vector<int> lineInts = getInts(tmpS, m);
 
-        if (lineInts.size() != firstLine.size()) { return GFMatrix(0); }
+        if (!valid) continue;
+        if (lineInts.size() != firstLine.size() || outOfRange(lineInts)) { valid = false; continue; }
 
         for (int j = 0; j < m; j++) rslt[i][j] = lineInts[j];
     }
 
-    return rslt;
+    return valid ? rslt : GFMatrix(0);
 }
 
 void GFMatrix::To(std::ostream& oss) const
 {
     for (int i = 0; i < m; i++)
     {
-        oss << at(i, 0);
-        for (int j = 1; j < m; j++) oss << " " << at(i, j);
+        oss << int(at(i, 0));
+        for (int j = 1; j < m; j++) oss << " " << int(at(i, j));
         oss << '\n';
     }
-}
\ No newline at end of file
+}
+
+bool ReadMatrices(std::istream& iss, std::vector<GFMatrix>& matrices)
+{
+    std::stringstream content;
+    std::string line;
+    while (std::getline(iss, line))
+    {
+        if (line.find_first_not_of(" \t") != std::string::npos && line[line.find_first_not_of(" \t")] == '#') 
+            continue;
+        content << line << '\n';
+    }
+
+    matrices.clear();
+    while (content >> std::ws, content.peek() != EOF)
+    {
+        GFMatrix mat = GFMatrix::From(content);
+        if (mat.size() == 0)
+        {
+            std::cerr << "Error: matrix " << matrices.size() + 1 << " is malformed" << std::endl;
+            return false;
+        }
+        matrices.push_back(mat);
+    }
+    return true;
+}
+
+bool ValidateBase(int q)
+{
+    if (q > int(std::numeric_limits<GFElement>::max()) + 1)
+    {
+#ifdef GFMATRIX_WIDE
+        std::cerr << "Error: base " << q << " is not supported (at most " << int(std::numeric_limits<GFElement>::max()) + 1 << ")" << std::endl;
+#else
+        std::cerr << "Error: base " << q << " needs a build with -DGF_WIDE=ON (bases above 256)" << std::endl;
+#endif
+        return false;
+    }
+    return true;
+}
+
+bool ValidateMatrices(const std::vector<GFMatrix>& matrices, int q)
+{
+    if (!ValidateBase(q)) return false;
+    if (matrices.empty())
+    {
+        std::cerr << "Error: no matrix" << std::endl;
+        return false;
+    }
+
+    for (const auto& mat : matrices)
+    {
+        if (mat.size() != matrices[0].size())
+        {
+            std::cerr << "Error: all matrices must have the same size !" << std::endl;
+            return false;
+        }
+
+        for (int i = 0; i < mat.size(); i++)
+        {
+            for (int j = 0; j < mat.size(); j++)
+            {
+                if (mat[i][j] >= q)
+                {
+                    std::cerr << "Error: matrix has numbers greater than base" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
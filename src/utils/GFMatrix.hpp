@@ -1,15 +1,38 @@
 #pragma once
 
 #include <galois++/field.h>
+#include "GFArithmetic.hpp"
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+
+// Coefficients are below q: one byte each, two when built with GF_WIDE (q > 256)
+#ifdef GFMATRIX_WIDE
+using GFElement = uint16_t;
+#else
+using GFElement = uint8_t;
+#endif
+
+// Non owning view of a matrix (or of its first rows), valid while the matrix lives
+class GFMatrixView
+{
+public:
+    GFMatrixView(const GFElement* data, int m, int stride): data(data), m(m), stride(stride) {}
+
+    int size() const { return m; }
+    const GFElement* operator[](int idx) const { return data + idx * stride; }
+private:
+    const GFElement* data;
+    int m;
+    int stride;
+};
 
 class GFMatrix
 {
 public:
-    explicit GFMatrix(int m): m(m), data(m * m, 0) {}
-    GFMatrix(const std::vector<int>& data): m(int(round(sqrt(data.size())))), data(data) {} 
+    explicit GFMatrix(int m): m(m), stride(Stride(m)), data(m * Stride(m), 0) {}
 
     static GFMatrix From(std::istream& iss);
 
@@ -17,19 +40,102 @@ public:
 
     int size() const { return m; }
 
-    int& at(int i, int j)       { return *(data.data() + j + i * m); }
-    int  at(int i, int j) const { return *(data.data() + j + i * m); }
+    GFElement& at(int i, int j)       { return *(data.data() + j + i * stride); }
+    GFElement  at(int i, int j) const { return *(data.data() + j + i * stride); }
     
-          int* operator[](int idx)       { return data.data() + idx * m; }
-    const int* operator[](int idx) const { return data.data() + idx * m; }
+          GFElement* operator[](int idx)       { return data.data() + idx * stride; }
+    const GFElement* operator[](int idx) const { return data.data() + idx * stride; }
+
+    GFMatrixView View() const { return GFMatrixView(data.data(), m, stride); }
+    operator GFMatrixView() const { return View(); }
 
     void Print() const;
 
     // int multiply(int other, const Galois::Field& gf) const;
     int determinant(const Galois::Field& gf, int override_m = -1) const;
+
+    // Same, for a field of GFArithmetic.hpp
+    template<class Field>
+    int Determinant(const Field& gf, int override_m = -1) const;
 private:
+    // Rows start on 16 byte boundaries (allocations are aligned at least as much)
+    static int Stride(int m) 
+    { 
+        const int perLine = 16 / sizeof(GFElement);
+        return (m + perLine - 1) / perLine * perLine; 
+    }
+
     int m;
-    std::vector<int> data;
+    int stride;
+    std::vector<GFElement> data;
 };
 
-GFMatrix TakeRowsFrom(const GFMatrix& first, const GFMatrix& second, int m);
\ No newline at end of file
+template<class Field>
+int GFMatrix::Determinant(const Field& gf, int override_m) const
+{
+    const int M = (override_m < 0) ?  m : std::min(m, override_m);
+
+    GFMatrix memory = *this;
+
+    int factorPermut = 1;
+    for (int i = 0; i < M; i++)
+    {
+        int swapi = i;
+        while (swapi < M && memory[swapi][i] == 0) swapi ++;
+
+        if (swapi >= M) return 0;
+        else if (swapi != i)
+        {
+            factorPermut *= -1;
+            for (int k = i; k < M; k++)
+            {
+                std::swap(memory[swapi][k], memory[i][k]);
+            }
+        }
+
+
+        for (int j = i + 1; j < M; j++)
+        {
+            if (memory[j][i] != 0)
+            {
+                int factor = gf.neg[
+                    gf.times(
+                        gf.inv[memory[i][i]], 
+                               memory[j][i]
+                    )
+                ];
+
+                for (int k = i; k < m; k++)
+                {
+                    memory[j][k] = gf.plus(
+                        memory[j][k], 
+                        gf.times(
+                            factor, 
+                            memory[i][k]
+                        )
+                    );
+                }
+            }
+        }
+    }
+
+    int res = 1;
+    for (int i = 0; i < M; i++)
+    {
+        res = gf.times(res, memory[i][i]);
+    }
+
+    if (factorPermut == 1) return res;
+    return gf.neg[res];
+}
+
+// Reads every matrix of a file, skipping comments (lines starting by #). 
+// False, with an error printed, if one of them is malformed.
+bool ReadMatrices(std::istream& iss, std::vector<GFMatrix>& matrices);
+
+// Whether coefficients of base q fit a GFElement. False, with an error printed, otherwise.
+bool ValidateBase(int q);
+
+// Whether there is at least one matrix, all of the same size, with coefficients below q.
+// False, with an error printed, otherwise.
+bool ValidateMatrices(const std::vector<GFMatrix>& matrices, int q);
\ No newline at end of file
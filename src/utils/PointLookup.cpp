@@ -0,0 +1,177 @@
+#include "PointLookup.hpp"
+
+#include <algorithm>
+
+PointLookup::PointLookup(const std::vector<GFMatrix>& matrices, int q) :
+    q(q), s(matrices.size()), m(matrices.empty() ? 0 : std::min(matrices[0].size(), PointGenerator::MaxSize))
+{
+    if (q == 2)
+    {
+        digitsPerGroup = 8;
+        values = 256;
+        groups = (m + 7) / 8;
+
+        bitTable.assign(size_t(groups) * values * s, 0);
+        for (int g = 0; g < groups; g++)
+        {
+            // Entry v is entry v without its lowest bit, plus the column of that bit
+            for (int v = 1; v < values; v++)
+            {
+                const int j = g * 8 + GF::CountTrailingZeros(v);
+                uint64_t* entry = bitTable.data() + (size_t(g) * values + v) * s;
+                const uint64_t* previous = bitTable.data() + (size_t(g) * values + (v & (v - 1))) * s;
+                for (int k = 0; k < s; k++)
+                {
+                    uint64_t column = 0;
+                    if (j < m)
+                        for (int r = 0; r < m; r++)
+                            if (matrices[k][r][j]) column |= uint64_t(1) << (63 - r);
+                    entry[k] = previous[k] ^ column;
+                }
+            }
+        }
+        return;
+    }
+
+    digitsPerGroup = 1;
+    values = q;
+    while (values * q <= 256)
+    {
+        values *= q;
+        digitsPerGroup++;
+    }
+    groups = (m + digitsPerGroup - 1) / digitsPerGroup;
+
+    const Galois::Field gf(q);
+    prime = GF::IsPrime(q);
+    if (!prime && q > GF::LargeBase)
+    {
+        logField = &GF::GetLogField(gf);
+    }
+    else if (!prime)
+    {
+        add.resize(q * q);
+        for (int a = 0; a < q; a++)
+            for (int b = 0; b < q; b++)
+                add[a * q + b] = GFElement(gf.plus(a, b));
+    }
+
+    digitTable.assign(size_t(groups) * values * m * s, 0);
+    for (int g = 0; g < groups; g++)
+    {
+        for (int v = 0; v < values; v++)
+        {
+            GFElement* entry = digitTable.data() + (size_t(g) * values + v) * m * s;
+            int rest = v;
+            for (int t = 0; t < digitsPerGroup; t++, rest /= q)
+            {
+                const int j = g * digitsPerGroup + t;
+                if (j >= m || rest % q == 0) continue;
+
+                for (int r = 0; r < m; r++)
+                    for (int k = 0; k < s; k++)
+                        entry[r * s + k] = GFElement(gf.plus(entry[r * s + k], gf.times(rest % q, matrices[k][r][j])));
+            }
+        }
+    }
+
+    weights.resize(m);
+    double weight = 1.;
+    for (int r = 0; r < m; r++)
+    {
+        weight /= q;
+        weights[r] = weight;
+    }
+}
+
+void PointLookup::Point(uint64_t index, double* out) const
+{
+    if (q != 2)
+    {
+        PointsBaseQ(&index, 1, out);
+        return;
+    }
+
+    const double scale = 1. / double(uint64_t(1) << 53);
+    for (int k = 0; k < s; k++)
+    {
+        uint64_t x = 0;
+        for (int g = 0; g < groups; g++)
+            x ^= bitTable[(size_t(g) * values + ((index >> (8 * g)) & 0xFF)) * s + k];
+        out[k] = double(x >> 11) * scale;
+    }
+}
+
+void PointLookup::Points(const uint64_t* indices, size_t count, double* out) const
+{
+    for (size_t first = 0; first < count; first += Batch)
+    {
+        const int size = int(std::min<size_t>(Batch, count - first));
+        if (q == 2) PointsBase2(indices + first, size, out + first * s);
+        else        PointsBaseQ(indices + first, size, out + first * s);
+    }
+}
+
+void PointLookup::PointsBase2(const uint64_t* indices, int count, double* out) const
+{
+    // Top 53 bits are kept, the conversion is exact
+    const double scale = 1. / double(uint64_t(1) << 53);
+
+    // Scratch space reused between calls
+    thread_local std::vector<uint64_t> x;
+    x.assign(size_t(count) * s, 0);
+    for (int g = 0; g < groups; g++)
+    {
+        for (int b = 0; b < count; b++)
+        {
+            const uint64_t* entry = bitTable.data() + (size_t(g) * values + ((indices[b] >> (8 * g)) & 0xFF)) * s;
+            uint64_t* point = x.data() + size_t(b) * s;
+            for (int k = 0; k < s; k++) point[k] ^= entry[k];
+        }
+    }
+
+    for (int i = 0; i < count * s; i++) out[i] = double(x[i] >> 11) * scale;
+}
+
+void PointLookup::PointsBaseQ(const uint64_t* indices, int count, double* out) const
+{
+    // Scratch space reused between calls
+    thread_local std::vector<uint64_t> rest;
+    thread_local std::vector<GFElement> y;
+    rest.assign(indices, indices + count);
+    y.assign(size_t(count) * m * s, 0);
+    for (int g = 0; g < groups; g++)
+    {
+        for (int b = 0; b < count; b++)
+        {
+            const GFElement* entry = digitTable.data() + (size_t(g) * values + rest[b] % values) * m * s;
+            GFElement* digits = y.data() + size_t(b) * m * s;
+            if (prime)
+            {
+                for (int i = 0; i < m * s; i++)
+                {
+                    const int sum = digits[i] + entry[i];
+                    digits[i] = GFElement(sum >= q ? sum - q : sum);
+                }
+            }
+            else if (logField)
+            {
+                for (int i = 0; i < m * s; i++) digits[i] = GFElement(logField->plus(digits[i], entry[i]));
+            }
+            else
+            {
+                for (int i = 0; i < m * s; i++) digits[i] = add[digits[i] * q + entry[i]];
+            }
+            rest[b] /= values;
+        }
+    }
+
+    std::fill(out, out + count * s, 0.);
+    for (int b = 0; b < count; b++)
+    {
+        const GFElement* digits = y.data() + size_t(b) * m * s;
+        double* point = out + size_t(b) * s;
+        for (int r = 0; r < m; r++)
+            for (int k = 0; k < s; k++) point[k] += digits[r * s + k] * weights[r];
+    }
+}
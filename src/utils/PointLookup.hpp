@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GFMatrix.hpp"
+#include "Points.hpp"
+
+// Random access to the points of the digital net given by generator matrices over GF(q)
+//
+// Index digits are grouped so that a group takes at most 256 values (8 bits in base 2),
+// and the contribution of every value of every group is tabulated for all dimensions.
+// A point is then the sum of one table entry per group: a few xors per dimension in
+// base 2, digit additions otherwise (modular for primes, tables for prime powers, up to
+// GF::LargeBase, logarithms above).
+//
+// Points are in natural order: point i is the i-th point of PointGenerator in bases
+// other than 2, and in base 2 its point whose index is the inverse Gray code of i.
+class PointLookup
+{
+public:
+    PointLookup(const std::vector<GFMatrix>& matrices, int q);
+
+    int Dimensions() const { return s; }
+
+    // Coordinates of point index in out (s values)
+    void Point(uint64_t index, double* out) const;
+
+    // Points of count indices, one after the other. Indices are handled by batches of
+    // 16, the loops over the batch are vectorized.
+    void Points(const uint64_t* indices, size_t count, double* out) const;
+
+    static const int Batch = 16;
+private:
+    void PointsBase2(const uint64_t* indices, int count, double* out) const;
+    void PointsBaseQ(const uint64_t* indices, int count, double* out) const;
+
+    int q;
+    int s;
+    int m;
+    // Index digits per group, and number of groups
+    int digitsPerGroup;
+    int groups;
+    // q^digitsPerGroup
+    int values;
+
+    // Base 2, table[(g * 256 + v) * s + k], row r on bit (63 - r)
+    std::vector<uint64_t> bitTable;
+
+    // Other bases, table[((g * values + v) * m + r) * s + k]
+    std::vector<GFElement> digitTable;
+    bool prime = false;
+    std::vector<GFElement> add;
+    const GF::LogField* logField = nullptr;
+    std::vector<double> weights;
+};
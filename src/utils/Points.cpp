@@ -0,0 +1,176 @@
+#include "Points.hpp"
+
+#include <algorithm>
+#include <thread>
+
+PointGenerator::PointGenerator(const std::vector<GFMatrix>& matrices, int q) :
+    q(q), s(matrices.size()), m(matrices.empty() ? 0 : std::min(matrices[0].size(), MaxSize)), prime(GF::IsPrime(q))
+{
+    if (q == 2)
+    {
+        columns.assign(size_t(m) * s, 0);
+        for (int j = 0; j < m; j++)
+            for (int k = 0; k < s; k++)
+                for (int r = 0; r < m; r++)
+                    if (matrices[k][r][j]) columns[j * s + k] |= uint64_t(1) << (63 - r);
+        return;
+    }
+
+    digits.assign(size_t(m) * m * s, 0);
+    for (int j = 0; j < m; j++)
+        for (int r = 0; r < m; r++)
+            for (int k = 0; k < s; k++)
+                digits[(size_t(j) * m + r) * s + k] = matrices[k][r][j];
+
+    if (prime) return;
+
+    const Galois::Field gf(q);
+    if (q > GF::LargeBase)
+    {
+        logField = &GF::GetLogField(gf);
+    }
+    else
+    {
+        add.resize(q * q);
+        mul.resize(q * q);
+        for (int a = 0; a < q; a++)
+        {
+            for (int b = 0; b < q; b++)
+            {
+                add[a * q + b] = GFElement(gf.plus(a, b));
+                mul[a * q + b] = GFElement(gf.times(a, b));
+            }
+        }
+    }
+
+    step.resize(q);
+    for (int a = 0; a < q; a++)
+        step[a] = GFElement(gf.plus((a + 1) % q, gf.neg[a]));
+}
+
+int PointGenerator::AddTimes(int y, int a, int c) const
+{
+    if (prime)    return int((y + uint64_t(a) * uint64_t(c)) % q);
+    if (logField) return logField->plus(y, logField->times(a, c));
+    return add[y * q + mul[a * q + c]];
+}
+
+uint64_t PointGenerator::Count() const
+{
+    uint64_t count = 1;
+    for (int j = 0; j < m; j++)
+    {
+        if (count > UINT64_MAX / q) return UINT64_MAX;
+        count *= q;
+    }
+    return count;
+}
+
+void PointGenerator::Generate(uint64_t first, uint64_t count, double* out) const
+{
+    if (q == 2) GenerateBase2(first, count, out);
+    else        GenerateBaseQ(first, count, out);
+}
+
+void PointGenerator::Generate(uint64_t first, uint64_t count, double* out, int threads) const
+{
+    const uint64_t nbThreads = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+    const uint64_t chunk = (count + nbThreads - 1) / nbThreads;
+
+    std::vector<std::thread> pool;
+    for (uint64_t start = chunk; start < count; start += chunk)
+    {
+        const uint64_t size = std::min(chunk, count - start);
+        pool.emplace_back([=]() { Generate(first + start, size, out + start * s); });
+    }
+    Generate(first, std::min(chunk, count), out);
+    for (auto& thread : pool) thread.join();
+}
+
+void PointGenerator::GenerateBase2(uint64_t first, uint64_t count, double* out) const
+{
+    // Top 53 bits are kept, the conversion is exact
+    const double scale = 1. / double(uint64_t(1) << 53);
+
+    std::vector<uint64_t> x(s, 0);
+    const uint64_t gray = first ^ (first >> 1);
+    for (int j = 0; j < m; j++)
+    {
+        if (!((gray >> j) & 1)) continue;
+        for (int k = 0; k < s; k++) x[k] ^= columns[j * s + k];
+    }
+
+    for (uint64_t n = 0; n < count; n++)
+    {
+        double* point = out + n * s;
+        for (int k = 0; k < s; k++) point[k] = double(x[k] >> 11) * scale;
+
+        // Gray code of index + 1 differs by the bit of its trailing zeros
+        const uint64_t next = first + n + 1;
+        if (next == 0) break;
+        const int j = GF::CountTrailingZeros(next);
+        if (j >= m) continue;
+
+        const uint64_t* column = columns.data() + j * s;
+        for (int k = 0; k < s; k++) x[k] ^= column[k];
+    }
+}
+
+void PointGenerator::GenerateBaseQ(uint64_t first, uint64_t count, double* out) const
+{
+    std::vector<double> weights(m);
+    double weight = 1.;
+    for (int r = 0; r < m; r++)
+    {
+        weight /= q;
+        weights[r] = weight;
+    }
+
+    // Digits of the index, and y of every dimension (y[r * s + k])
+    std::vector<int> index(m, 0);
+    std::vector<GFElement> y(size_t(m) * s, 0);
+    uint64_t rest = first;
+    for (int j = 0; j < m && rest; j++, rest /= q)
+    {
+        index[j] = rest % q;
+        const GFElement* column = digits.data() + size_t(j) * m * s;
+        for (int i = 0; i < m * s; i++) y[i] = GFElement(AddTimes(y[i], index[j], column[i]));
+    }
+
+    for (uint64_t n = 0; n < count; n++)
+    {
+        double* point = out + n * s;
+        std::fill(point, point + s, 0.);
+        for (int r = 0; r < m; r++)
+        {
+            const GFElement* row = y.data() + r * s;
+            for (int k = 0; k < s; k++) point[k] += row[k] * weights[r];
+        }
+
+        // Each digit changed by the increment (the carries) adds its column once
+        for (int j = 0; j < m; j++)
+        {
+            const GFElement* column = digits.data() + size_t(j) * m * s;
+            if (prime)
+            {
+                for (int i = 0; i < m * s; i++)
+                {
+                    const int sum = y[i] + column[i];
+                    y[i] = GFElement(sum >= q ? sum - q : sum);
+                }
+            }
+            else if (logField)
+            {
+                for (int i = 0; i < m * s; i++) y[i] = GFElement(AddTimes(y[i], step[index[j]], column[i]));
+            }
+            else
+            {
+                const GFElement* factor = mul.data() + step[index[j]] * q;
+                for (int i = 0; i < m * s; i++) y[i] = add[y[i] * q + factor[column[i]]];
+            }
+
+            if (++index[j] < q) break;
+            index[j] = 0;
+        }
+    }
+}
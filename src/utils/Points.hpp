@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GFMatrix.hpp"
+
+// Points in [0, 1)^s of the digital net given by generator matrices over GF(q)
+//
+// Point i has coordinates x_k = sum_r y_r q^-(r + 1), with y = C_k a where a are the
+// base q digits of i (least significant first, column j of C_k multiplies digit j).
+//
+// In base 2 points are enumerated in Gray code order: the n-th point generated is
+// point gray(n) = n ^ (n >> 1) of the net, obtained from the previous one with one
+// xor per dimension. In other bases they are in natural order, incrementing the digits
+// of the index: each digit that changes adds its column to y once (times the difference
+// of the field elements for prime powers).
+//
+// Updates loop over dimensions on contiguous arrays, so that they are vectorized.
+// Only the first MaxSize columns (and rows) of the matrices are used.
+class PointGenerator
+{
+public:
+    static constexpr int MaxSize = 64;
+
+    PointGenerator(const std::vector<GFMatrix>& matrices, int q);
+
+    int Dimensions() const { return s; }
+    int Size() const { return m; }
+    // q^m, the number of distinct points (saturates for large nets)
+    uint64_t Count() const;
+
+    // Points first to first + count - 1, one after the other (s values each)
+    void Generate(uint64_t first, uint64_t count, double* out) const;
+
+    // Same, the range is split between threads (0 uses every available core)
+    void Generate(uint64_t first, uint64_t count, double* out, int threads) const;
+private:
+    void GenerateBase2(uint64_t first, uint64_t count, double* out) const;
+    void GenerateBaseQ(uint64_t first, uint64_t count, double* out) const;
+
+    // y + a c in the field
+    int AddTimes(int y, int a, int c) const;
+
+    int q;
+    int s;
+    int m;
+    bool prime;
+
+    // Base 2, column j of every dimension: columns[j * s + k], row r on bit (63 - r)
+    std::vector<uint64_t> columns;
+
+    // Other bases, column j of every dimension: digits[(j * m + r) * s + k]
+    std::vector<GFElement> digits;
+    // Prime powers: field tables up to GF::LargeBase, logarithms above
+    std::vector<GFElement> add, mul;
+    const GF::LogField* logField = nullptr;
+    // step[a] = (a + 1 mod q) - a in the field
+    std::vector<GFElement> step;
+};
@@ -0,0 +1,200 @@
+#include "Scrambling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <galois++/field.h>
+
+static uint32_t ReverseBits(uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Each bit only depends on the lower ones: applied to reversed bits, every digit is
+// permuted according to the previous digits (Laine and Karras, Burley 2020)
+static uint32_t LaineKarras(uint32_t x, uint32_t seed)
+{
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return x;
+}
+
+static uint32_t Mix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+Scrambler::Scrambler(int q, int s, Type type, uint64_t seed) :
+    q(q), s(s), type(type)
+{
+    std::mt19937_64 rng(seed);
+    if (q == 2)
+    {
+        shifts.resize(s);
+        seeds.resize(s);
+        for (int k = 0; k < s; k++)
+        {
+            shifts[k] = rng();
+            seeds[k] = uint32_t(rng());
+        }
+        return;
+    }
+
+    // Digits are read back from doubles, a few bits are kept as margin for rounding errors
+    while (scale * q <= double(uint64_t(1) << 48))
+    {
+        scale *= q;
+        digits++;
+    }
+
+    seeds.resize(s);
+    shiftDigits.resize(size_t(s) * digits);
+    for (int k = 0; k < s; k++)
+    {
+        seeds[k] = uint32_t(rng());
+        for (int r = 0; r < digits; r++) shiftDigits[k * digits + r] = GFElement(rng() % q);
+    }
+
+    const Galois::Field gf(q);
+    prime = GF::IsPrime(q);
+    if (prime) return;
+    if (q > GF::LargeBase)
+    {
+        logField = &GF::GetLogField(gf);
+        return;
+    }
+
+    add.resize(q * q);
+    mul.resize(q * q);
+    for (int a = 0; a < q; a++)
+    {
+        for (int b = 0; b < q; b++)
+        {
+            add[a * q + b] = GFElement(gf.plus(a, b));
+            mul[a * q + b] = GFElement(gf.times(a, b));
+        }
+    }
+}
+
+inline int Scrambler::Add(int a, int b) const
+{
+    if (prime)    return (a + b) % q;
+    if (logField) return logField->plus(a, b);
+    return add[a * q + b];
+}
+
+inline int Scrambler::Mul(int a, int b) const
+{
+    if (prime)    return int(uint32_t(a) * uint32_t(b) % uint32_t(q));
+    if (logField) return logField->times(a, b);
+    return mul[a * q + b];
+}
+
+void Scrambler::Apply(double* points, uint64_t count) const
+{
+    if (type == Type::None) return;
+
+    if (q == 2) ApplyBase2(points, count);
+    else        ApplyBaseQ(points, count);
+}
+
+void Scrambler::Apply(double* points, uint64_t count, int threads) const
+{
+    if (type == Type::None) return;
+
+    const uint64_t nbThreads = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+    const uint64_t chunk = (count + nbThreads - 1) / nbThreads;
+
+    std::vector<std::thread> pool;
+    for (uint64_t start = chunk; start < count; start += chunk)
+    {
+        const uint64_t size = std::min(chunk, count - start);
+        pool.emplace_back([=]() { Apply(points + start * s, size); });
+    }
+    Apply(points, std::min(chunk, count));
+    for (auto& thread : pool) thread.join();
+}
+
+void Scrambler::ApplyBase2(double* points, uint64_t count) const
+{
+    const double toInt = 18446744073709551616.; // 2^64
+    const double toDouble = 1. / double(uint64_t(1) << 53);
+
+    if (type == Type::DigitalShift)
+    {
+        for (uint64_t n = 0; n < count; n++)
+        {
+            double* point = points + n * s;
+            for (int k = 0; k < s; k++)
+                point[k] = double((uint64_t(point[k] * toInt) ^ shifts[k]) >> 11) * toDouble;
+        }
+        return;
+    }
+
+    // Only 32 bit integers, so that the loop over dimensions is vectorized
+    const double toHigh = 4294967296.; // 2^32
+    const double fromHigh = 1. / toHigh;
+    const double fromLow  = fromHigh * fromHigh;
+    for (uint64_t n = 0; n < count; n++)
+    {
+        double* point = points + n * s;
+        for (int k = 0; k < s; k++)
+        {
+            const uint32_t high = ReverseBits(LaineKarras(ReverseBits(uint32_t(int64_t(point[k] * toHigh))), seeds[k]));
+            point[k] = double(high) * fromHigh + double(Mix(high ^ seeds[k]) >> 11 << 11) * fromLow;
+        }
+    }
+}
+
+void Scrambler::ApplyBaseQ(double* points, uint64_t count) const
+{
+    // Products are within 1/16 of the exact value (2^-53 relative error on the point and on
+    // the product), points of the net sitting on a digit boundary are not moved below it
+    const double margin = 1. / 8;
+
+    std::vector<GFElement> d(digits);
+    for (uint64_t n = 0; n < count; n++)
+    {
+        double* point = points + n * s;
+        for (int k = 0; k < s; k++)
+        {
+            uint64_t x = std::min(uint64_t(point[k] * scale + margin), uint64_t(scale) - 1);
+            for (int r = digits - 1; r >= 0; r--, x /= q) d[r] = GFElement(x % q);
+
+            // Digits from the most significant one, the hash follows the original prefix
+            uint32_t h = seeds[k];
+            for (int r = 0; r < digits; r++)
+            {
+                const int digit = d[r];
+                if (type == Type::DigitalShift)
+                {
+                    d[r] = GFElement(Add(digit, shiftDigits[k * digits + r]));
+                }
+                else
+                {
+                    const uint32_t hash = Mix(h);
+                    const int a = 1 + int(hash % uint32_t(q - 1));
+                    const int b = int((hash >> 16) % uint32_t(q));
+                    d[r] = GFElement(Add(Mul(a, digit), b));
+                    h = hash + uint32_t(digit) + 1;
+                }
+            }
+
+            for (int r = 0; r < digits; r++) x = x * q + d[r];
+            point[k] = double(x) / scale;
+        }
+    }
+}
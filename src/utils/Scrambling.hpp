@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "GFMatrix.hpp"
+
+// Randomization of digital net points in [0, 1)^s, applied in place to the output of
+// PointGenerator or PointLookup.
+//
+// DigitalShift adds a random digit vector (per dimension) to the digits of every point,
+// xor in base 2.
+//
+// Owen is nested scrambling: each digit is permuted by a permutation that depends on the
+// dimension and on the digits before it, drawn from a hash instead of being stored.
+// In base 2, the first 32 digits are scrambled by the Laine-Karras hash on reversed
+// bits, the following ones are random. In other bases, permutations are random affine
+// maps d -> a d + b over GF(q) (every permutation when q <= 3) on the digits that fit a
+// double. Digits are read by truncation, so that the prefix of a point is its own.
+class Scrambler
+{
+public:
+    enum class Type { None, DigitalShift, Owen };
+
+    Scrambler(int q, int s, Type type, uint64_t seed);
+
+    // Scrambles count points (s values each)
+    void Apply(double* points, uint64_t count) const;
+
+    // Same, the points are split between threads (0 uses every available core)
+    void Apply(double* points, uint64_t count, int threads) const;
+private:
+    void ApplyBase2(double* points, uint64_t count) const;
+    void ApplyBaseQ(double* points, uint64_t count) const;
+    int Add(int a, int b) const;
+    int Mul(int a, int b) const;
+
+    int q;
+    int s;
+    Type type;
+
+    // Per dimension, base 2
+    std::vector<uint64_t> shifts;
+    std::vector<uint32_t> seeds;
+
+    // Other bases: scrambled digits (q^digits fits a double exactly)
+    int digits = 0;
+    double scale = 1.;
+    std::vector<GFElement> shiftDigits;
+    bool prime = false;
+    std::vector<GFElement> add, mul;
+    const GF::LogField* logField = nullptr;
+};
@@ -0,0 +1,223 @@
+#include "TValue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+
+namespace
+{
+    // Basis of rows (restricted to the first m columns) kept reduced: each row has a
+    // distinct pivot, its first non zero column. Rows are added and removed as a stack.
+    template<class Field>
+    class IncrementalBasis
+    {
+    public:
+        IncrementalBasis(const std::vector<GFMatrix>& matrices, const Field& gf) :
+            gf(gf), q(gf.q), size(matrices.empty() ? 0 : matrices[0].size()), words((size + 63) / 64)
+        {
+            if (q == 2)
+            {
+                bits.assign(matrices.size() * size * words, 0);
+                for (size_t d = 0; d < matrices.size(); d++)
+                    for (int i = 0; i < size; i++)
+                        for (int j = 0; j < size; j++)
+                            if (matrices[d][i][j]) bits[(d * size + i) * words + j / 64] |= uint64_t(1) << (j % 64);
+            }
+            else
+            {
+                values.resize(matrices.size() * size * size);
+                for (size_t d = 0; d < matrices.size(); d++)
+                    for (int i = 0; i < size; i++)
+                        for (int j = 0; j < size; j++)
+                            values[(d * size + i) * size + j] = matrices[d][i][j];
+            }
+        }
+
+        void Reset(int columns)
+        {
+            m = columns;
+            used = (q == 2) ? (m + 63) / 64 : m;
+            count = 0;
+            pivot.assign(m, -1);
+            pivotOf.resize(m);
+            stackBits.resize(size_t(m) * used);
+            stackValues.resize(size_t(m) * used);
+        }
+
+        // Adds row i of matrix d, returns false (and adds nothing) if it is dependent
+        bool Push(int d, int i)
+        {
+            if (count == m) return false;
+
+            int col = (q == 2) ? ReduceBits(d, i) : ReduceValues(d, i);
+            if (col < 0) return false;
+
+            pivot[col] = count;
+            pivotOf[count] = col;
+            count++;
+            return true;
+        }
+
+        void Pop(int rows)
+        {
+            for (int r = 0; r < rows; r++)
+                pivot[pivotOf[--count]] = -1;
+        }
+    private:
+        int ReduceBits(int d, int i)
+        {
+            const uint64_t lastMask = (m % 64 == 0) ? ~uint64_t(0) : ((uint64_t(1) << (m % 64)) - 1);
+            uint64_t* v = stackBits.data() + size_t(count) * used;
+            const uint64_t* src = bits.data() + (size_t(d) * size + i) * words;
+            std::copy(src, src + used, v);
+            v[used - 1] &= lastMask;
+
+            int w = 0;
+            while (true)
+            {
+                while (w < used && v[w] == 0) w++;
+                if (w == used) return -1;
+
+                const int col = w * 64 + GF::CountTrailingZeros(v[w]);
+                if (pivot[col] < 0) return col;
+
+                const uint64_t* p = stackBits.data() + size_t(pivot[col]) * used;
+                for (int x = w; x < used; x++) v[x] ^= p[x];
+            }
+        }
+
+        int ReduceValues(int d, int i)
+        {
+            GFElement* v = stackValues.data() + size_t(count) * used;
+            const GFElement* src = values.data() + (size_t(d) * size + i) * size;
+            std::copy(src, src + m, v);
+
+            int col = 0;
+            while (true)
+            {
+                while (col < m && v[col] == 0) col++;
+                if (col == m) return -1;
+
+                if (pivot[col] < 0)
+                {
+                    // Basis rows start with 1
+                    const int scale = gf.inv[v[col]];
+                    for (int x = col; x < m; x++) v[x] = GFElement(gf.times(scale, v[x]));
+                    return col;
+                }
+
+                const GFElement* p = stackValues.data() + size_t(pivot[col]) * used;
+                const int factor = gf.neg[v[col]];
+                for (int x = col; x < m; x++) v[x] = GFElement(gf.plus(v[x], gf.times(factor, p[x])));
+            }
+        }
+
+        const Field& gf;
+        int q;
+        int size;
+        int words;
+
+        std::vector<uint64_t> bits;
+        std::vector<GFElement> values;
+
+        int m = 0;
+        int used = 0;
+        int count = 0;
+        std::vector<int> pivot;
+        std::vector<int> pivotOf;
+        std::vector<uint64_t> stackBits;
+        std::vector<GFElement> stackValues;
+    };
+
+    // True if every split of k rows between dims[i..] (on top of the current basis) is independent
+    template<class Basis>
+    bool AllIndependent(Basis& basis, const std::vector<int>& dims, size_t i, int k)
+    {
+        if (i + 1 == dims.size())
+        {
+            int pushed = 0;
+            bool valid = true;
+            while (pushed < k && (valid = basis.Push(dims[i], pushed))) pushed++;
+            basis.Pop(pushed);
+            return valid;
+        }
+
+        // Rows of dims[i] are added one at a time, the following dimensions share them
+        int pushed = 0;
+        bool valid = true;
+        for (int ki = 0; ki <= k && valid; ki++)
+        {
+            if (ki > 0)
+            {
+                valid = basis.Push(dims[i], ki - 1);
+                if (!valid) break;
+                pushed++;
+            }
+            valid = AllIndependent(basis, dims, i + 1, k - ki);
+        }
+        basis.Pop(pushed);
+        return valid;
+    }
+
+    void ForEachProjection(int s, int maxOrder, std::vector<int>& dims, std::vector<std::vector<int>>& out)
+    {
+        if (!dims.empty()) out.push_back(dims);
+        if (int(dims.size()) == maxOrder) return;
+
+        for (int d = dims.empty() ? 0 : dims.back() + 1; d < s; d++)
+        {
+            dims.push_back(d);
+            ForEachProjection(s, maxOrder, dims, out);
+            dims.pop_back();
+        }
+    }
+}
+
+std::vector<ProjectionTValue> ComputeTValues(const std::vector<GFMatrix>& matrices, int p, int maxOrder, int threads)
+{
+    const Galois::Field gf(p);
+    const int size = matrices.empty() ? 0 : matrices[0].size();
+
+    std::vector<std::vector<int>> projections;
+    std::vector<int> dims;
+    ForEachProjection(matrices.size(), maxOrder, dims, projections);
+    std::sort(projections.begin(), projections.end(), [](const std::vector<int>& a, const std::vector<int>& b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    });
+
+    std::vector<ProjectionTValue> result(projections.size());
+
+    const uint32_t nbThreads = (threads > 0) ? threads : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<uint32_t> next(0);
+    auto work = [&]() {
+        GF::WithField(gf, [&](const auto& field) {
+            IncrementalBasis<std::decay_t<decltype(field)>> basis(matrices, field);
+            uint32_t j;
+            while ((j = next++) < projections.size())
+            {
+                ProjectionTValue& projection = result[j];
+                projection.dims = projections[j];
+                projection.t.resize(size);
+
+                // Largest k such that every split of k rows is independent
+                int strength = 0;
+                for (int m = 1; m <= size; m++)
+                {
+                    basis.Reset(m);
+                    while (strength < m && AllIndependent(basis, projection.dims, 0, strength + 1))
+                        strength++;
+                    projection.t[m - 1] = m - strength;
+                }
+            }
+        });
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t i = 1; i < nbThreads; i++) pool.emplace_back(work);
+    work();
+    for (auto& thread : pool) thread.join();
+
+    return result;
+}
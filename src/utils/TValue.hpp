@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "GFMatrix.hpp"
+
+// Quality of a projection (subset of dimensions) as a digital (t, m, d)-net, for
+// each prefix of m columns of the matrices
+struct ProjectionTValue
+{
+    std::vector<int> dims;
+    // t[m - 1] is the t-value of the first b^m points
+    std::vector<int> t;
+};
+
+// Exact t-values of every projection with 1 to maxOrder dimensions, for m = 1 to the
+// matrix size. Projections are shared between threads (0 uses every available core).
+//
+// For each m, the rows taken from the projection are added one at a time (depth
+// first over the compositions) to an incrementally reduced basis. Since independent
+// rows stay independent with more columns, the search at m + 1 starts from the
+// strength found at m, that is t(m + 1) <= t(m) + 1.
+std::vector<ProjectionTValue> ComputeTValues(const std::vector<GFMatrix>& matrices, int p, int maxOrder, int threads = 0);
@@ -4,6 +4,9 @@
 
 #include "ILP/backends/Backend.hpp"
 #include "Matbuilder/Solver.hpp"
+#include "Matbuilder/Checkpoint.hpp"
+#include "Matbuilder/StreamLog.hpp"
+#include "Matbuilder/Verifier.hpp"
 #include "CLI11.hpp"
 
 template <class BackendType>
@@ -24,7 +27,7 @@ int matbuilder_solve(const char* backendName, int argc, char** argv)
     int s = -1;
     app.add_option("-s", s, "Override file number of dimensions");
     bool check = false;
-    app.add_flag("--check", check, "Check properties (unit test)");
+    app.add_flag("--check", check, "Checks every constraint on the resulting matrices");
     int b = -1;
     app.add_option("-b", b, "Override matrices basis");
     int nbThreads = 0;
@@ -37,11 +40,48 @@ int matbuilder_solve(const char* backendName, int argc, char** argv)
     app.add_option("--seed", seed, "Program seed");
     bool no_seed = false;
     app.add_flag("--no-seed", no_seed, "Disables seed objective in optimizer");
+    bool auxObjective = false;
+    app.add_flag("--auxObjective", auxObjective, "Writes seed objective with two rows per variable");
     bool header = false;
     app.add_flag("--header", header, "Writes profile as comments at the beginning of matrix file");
+    int poolSize = 1;
+    app.add_option("--pool", poolSize, "Number of solutions kept per step for backtracking (def: 1)");
+    bool backjump = false;
+    app.add_flag("--backjump", backjump, "Backtracks to the column responsible for a conflict");
+    int conflictSolves = 200;
+    app.add_option("--conflictSolves", conflictSolves, "Maximum solves to find a conflict without solver support (def: 200)");
+    std::string checkpointFile;
+    app.add_option("--checkpoint", checkpointFile, "Periodically saves solver state to this file");
+    int checkpointInterval = 600;
+    app.add_option("--checkpointInterval", checkpointInterval, "Seconds between checkpoints (def: 600)");
+    std::string resumeFile;
+    app.add_option("--resume", resumeFile, "Continues the run saved in this checkpoint");
+    std::string initFile;
+    app.add_option("--init", initFile, "Starts from the first columns of these matrices");
+    std::string streamFile;
+    app.add_option("--stream", streamFile, "Logs columns to this binary file as they are solved");
+    bool dryRun = false;
+    app.add_flag("--dry-run", dryRun, "Prints upper bounds on the size of each step program, without solving");
+    double memoryBudget = 0;
+    app.add_option("--memory", memoryBudget, "Stops before a step program whose upper bound is larger than this (MB, def: no limit)");
+    int samples = 0;
+    app.add_option("--samples", samples, "Random columns tried before calling the solver at each step (def: 0)");
+    int dimBatch = 0;
+    app.add_option("--dimBatch", dimBatch, "Solves this many dimensions at a time, previous ones fixed (def: 0, all at once)");
     
     CLI11_PARSE(app, argc, argv);
     
+    if (!initFile.empty() && !resumeFile.empty())
+    {
+        std::cerr << "--init and --resume can not be used together" << std::endl;
+        return -1;
+    }
+    if (dimBatch > 0 && !(initFile.empty() && resumeFile.empty() && checkpointFile.empty() && streamFile.empty()))
+    {
+        std::cerr << "--dimBatch can not be used with --init, --resume, --checkpoint or --stream" << std::endl;
+        return -1;
+    }
+
     Parser parser;
     parser.RegisterConstraint("net",        Constraint::Create<ZeroNetConstraint>);
     parser.RegisterConstraint("stratified", Constraint::Create<StratifiedConstraint>);
@@ -57,22 +97,117 @@ int matbuilder_solve(const char* backendName, int argc, char** argv)
     bParams.threads = nbThreads;
     bParams.tol     = tolerance_ratio;
     bParams.to      = timeout;
+    bParams.conflictSolves = conflictSolves;
+    bParams.objective = auxObjective ? ObjectiveEncoding::Auxiliary : ObjectiveEncoding::Compact;
     
     Solver::SolverParams sParams;
     sParams.backtrackMax  = nbBacktrack;
     sParams.greedyFailMax = nbTrials;
     sParams.rng.seed(seed);
     sParams.randomObjective = !no_seed;
+    sParams.poolSize = poolSize;
+    sParams.backjump = backjump;
+    sParams.checkpointFile = checkpointFile;
+    sParams.checkpointInterval = checkpointInterval;
+    sParams.seed = seed;
+    sParams.memoryBudget = memoryBudget;
+    sParams.samples = samples;
 
     if (!program.is_valid)
     {
         std::cout << "Invalid program" << std::endl;
         return -1;
     }
+    if (!ValidateBase(program.p)) return -1;
+    RemoveImpliedConstraints(program, std::cout);
+    sParams.programHash = ProgramHash(filename, program);
+
+    Solver::State state;
+    if (!resumeFile.empty())
+    {
+        Checkpoint checkpoint;
+        if (!Checkpoint::Load(resumeFile, checkpoint))
+        {
+            std::cerr << "Can not read checkpoint " << resumeFile << std::endl;
+            return -1;
+        }
+        if (checkpoint.hash != sParams.programHash || 
+            int(checkpoint.state.result.size()) != program.s || 
+            checkpoint.state.result[0].size() != program.m)
+        {
+            std::cerr << "Checkpoint " << resumeFile << " was not made for this profile" << std::endl;
+            return -1;
+        }
+        if (checkpoint.seed != seed)
+            std::cerr << "Warning: checkpoint was made with seed " << checkpoint.seed << std::endl;
+
+        sParams.seed = checkpoint.seed;
+        sParams.rng  = checkpoint.rng;
+        state = checkpoint.state;
+        std::cout << "Resuming at m = " << state.m << std::endl;
+    }
+    else if (!initFile.empty())
+    {
+        std::ifstream initF(initFile);
+        if (!initF.is_open())
+        {
+            std::cerr << "No such file or directory : " << initFile << std::endl;
+            return -1;
+        }
+
+        std::vector<GFMatrix> matrices;
+        if (!ReadMatrices(initF, matrices))
+        {
+            std::cerr << "Can not read initial matrices from " << initFile << std::endl;
+            return -1;
+        }
+        if (matrices.size() != 0)
+        {
+            if (!Solver::ValidateMatrices(program, matrices))
+                return -1;
+            if (int(matrices[0].size()) > program.m)
+            {
+                std::cerr << "Error: initial matrices are larger than m = " << program.m << std::endl;
+                return -1;
+            }
+            if (!Solver::VerifyPrefix(program, matrices, matrices[0].size()))
+            {
+                std::cerr << "Initial matrices do not satisfy the profile" << std::endl;
+                return -1;
+            }
+        }
+
+        state.Init(program, matrices);
+        Solver::AdvanceRNG(sParams.rng, program, state.prefix);
+        std::cout << "Starting at m = " << state.m << std::endl;
+    }
+
+    StreamLog stream;
+    if (!streamFile.empty())
+    {
+        if (!stream.Open(streamFile, program))
+        {
+            std::cerr << "Can not open stream file " << streamFile << std::endl;
+            return -1;
+        }
+        sParams.stream = &stream;
+    }
 
     BackendType backend(bParams);
     Solver solver(sParams, &backend);
-    const auto matrices = solver.solve(program);
+
+    if (dryRun)
+    {
+        std::cout << "m\trows\tvariables\tnon zeros\tmemory (MB)" << '\n';
+        for (int m = 1; m <= program.m; m++)
+        {
+            const auto size = solver.EstimateILP(program, m);
+            std::cout << m << '\t' << size.rows << '\t' << size.variables << '\t' << size.nonZeros << '\t' 
+                      << size.Bytes() / (1024. * 1024.) << '\n';
+        }
+        return 0;
+    }
+    const auto matrices = (dimBatch > 0) ? solver.solveByDimensions(program, dimBatch) : solver.solve(program, state);
 
     std::ofstream fileOut(outfile);
     std::ostream* out = &std::cout;
@@ -93,5 +228,17 @@ int matbuilder_solve(const char* backendName, int argc, char** argv)
         *out << '\n';
     }
 
+    if (check)
+    {
+        // Constraints implied by others were removed from program, all are checked
+        auto full = parser.Parse(filename);
+        if (s > 0) full.s = s;
+        if (b > 0) full.p = b;
+        if (fullSize > 0) full.m = fullSize;
+
+        if (!PrintCheckReport(full, CheckMatrices(full, matrices, nbThreads), std::cout))
+            return 2;
+    }
+
     return 0;
 }
\ No newline at end of file